@@ -47,10 +47,21 @@ namespace dbaudio
  */
 typedef juce::int32 SourceId;
 typedef juce::int32 PluginId;
+typedef juce::int32 DeviceId;
 typedef juce::uint64 DataChangeTypes;
 typedef juce::uint8 ComsMode;
 
 
+/**
+ * Value ranges.
+ */
+static constexpr SourceId SOURCE_ID_MIN = 1;		//< Minimum maxtrix input number / SourceId
+static constexpr SourceId SOURCE_ID_MAX = 64;		//< Highest maxtrix input number / SourceId, on each device
+static constexpr SourceId INVALID_SOURCE_ID = -1;	//< No SourceId, i.e. none is free
+static constexpr int MAPPING_ID_MIN = 1;			//< Lowest coordinate mapping index
+static constexpr int MAPPING_ID_MAX = 4;			//< Highest coordinate mapping index
+
+
 /**
  * Data Change Source
  * Enum used to define where a parameter or property change has originated.
@@ -65,6 +76,18 @@ enum DataChangeSource
 };
 
 
+/**
+ * Processor Queue
+ * Enum used to define the lists of Plug-in instances which the CController needs to visit.
+ */
+enum ProcessorQueue
+{
+	PQ_Tick = 0,		//< Plug-ins to visit during the next timer tick.
+	PQ_Set,				//< Plug-ins with SET commands to send once the low-latency deadline expires.
+	PQ_Max				//< Number of processor queues.
+};
+
+
 /**
  * Automation parameter indeces
  */
@@ -93,7 +116,8 @@ static constexpr DataChangeTypes DCT_OscConfig				= (DCT_IPAddress | DCT_Message
 static constexpr DataChangeTypes DCT_SourceID				= 0x00000010; //< The SourceID / Matrix input number of this Plug-in instance has been changed.
 static constexpr DataChangeTypes DCT_MappingID				= 0x00000020; //< The user has selected a different coordinate mapping for this Plug-in.
 static constexpr DataChangeTypes DCT_ComsMode				= 0x00000040; //< The Rx / Tx mode of this Plug-in has been changed.
-static constexpr DataChangeTypes DCT_PluginInstanceConfig	= (DCT_SourceID | DCT_MappingID | DCT_ComsMode); //< SourceID, MappingID, and Rx/Tx.
+static constexpr DataChangeTypes DCT_DeviceID				= 0x00004000; //< The DS100 device to which this Plug-in instance is bound has been changed.
+static constexpr DataChangeTypes DCT_PluginInstanceConfig	= (DCT_SourceID | DCT_MappingID | DCT_ComsMode | DCT_DeviceID); //< SourceID, MappingID, Rx/Tx, and DeviceID.
 static constexpr DataChangeTypes DCT_SourcePosition			= 0x00000080; //< The X/Y coordinates of this SourceID have changed.
 static constexpr DataChangeTypes DCT_ReverbSendGain			= 0x00000100; //< The En-Space Gain for this SourceID has changed.
 static constexpr DataChangeTypes DCT_SourceSpread			= 0x00000200; //< The En-Scene Spread factor for this SourceID has changed.
@@ -101,6 +125,8 @@ static constexpr DataChangeTypes DCT_DelayMode				= 0x00000400; //< The En-Scene
 static constexpr DataChangeTypes DCT_Bypass					= 0x00000800; //< The OSC Bypass parameter has changed.
 static constexpr DataChangeTypes DCT_AutomationParameters	= (DCT_SourcePosition | DCT_ReverbSendGain | DCT_SourceSpread | DCT_DelayMode | DCT_Bypass); //< All automation parameters.
 static constexpr DataChangeTypes DCT_DebugMessage			= 0x00001000; //< There is a new debug message to be displayed on the GUI.
+static constexpr DataChangeTypes DCT_RefreshInterval		= 0x00002000; //< The effective interval at which each source's parameters are polled has changed.
+static constexpr DataChangeTypes DCT_GlobalSettings			= (DCT_NumPlugins | DCT_OscConfig | DCT_RefreshInterval); //< Settings and states of the CController, rather than of a Plug-in instance.
 
 
 /**
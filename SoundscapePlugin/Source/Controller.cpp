@@ -35,6 +35,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "Controller.h"
 #include "Overview.h"
+#include "Parameters.h"
 #include "PluginProcessor.h"
 
 
@@ -42,36 +43,341 @@ namespace dbaudio
 {
 
 
-static constexpr int OSC_INTERVAL_MIN = 40;		//< Minimum supported OSC messaging rate in milliseconds
+static constexpr int OSC_INTERVAL_MIN = 5;		//< Minimum supported OSC messaging rate in milliseconds
 static constexpr int OSC_INTERVAL_MAX = 5000;	//< Maximum supported OSC messaging rate in milliseconds
 static constexpr int OSC_INTERVAL_DEF = 50;		//< Default OSC messaging rate in milliseconds
 
 static const String OSC_DEFAULT_IP("127.0.0.1");	//< Default IP Address
 
-static constexpr int RX_PORT_DS100 = 50010;		//< UDP port which the DS100 is listening to for OSC
 static constexpr int RX_PORT_HOST = 50011;		//< UDP port to which the DS100 will send OSC replies
 
-static constexpr int KEEPALIVE_TIMEOUT = 5000;	//< Milliseconds without response after which we consider plugin "Offline"
-static constexpr int KEEPALIVE_INTERVAL = 1500;	//< Interval at which keepalive (ping) messages are sent, in milliseconds
-static constexpr int MAX_HEARTBEAT_COUNT = 0xFFFF;	//< No point counting beyond this number.
+static constexpr int SET_DEADLINE = 2;			//< Time after a local change until its SET command goes out in low-latency mode, in milliseconds
+static constexpr int SET_INTERVAL_MIN = 10;		//< Minimum interval between low-latency SET commands for one source, in milliseconds
+static constexpr int RX_APPLY_INTERVAL_MIN = 20;	//< Minimum interval at which received values are applied to the Plug-ins (about one GUI frame), in milliseconds
+static constexpr int PLUGIN_ID_SLOT_BITS = 16;	//< Number of low bits of a PluginId which hold its slot index, the bits above hold the slot's generation
+static constexpr PluginId PLUGIN_ID_SLOT_MASK = (1 << PLUGIN_ID_SLOT_BITS) - 1;
+static constexpr PluginId PLUGIN_ID_GENERATION_MASK = 0x7fff;	//< Keeps PluginIds positive, so that -1 remains invalid
+static constexpr int TICK_JITTER_REPORT = 10000;	//< Interval at which the tick jitter histogram is logged in debug builds, in milliseconds
+static constexpr int TICK_JITTER_BIN_LIMITS[CController::TICK_JITTER_BINS] = 
+	{ 250, 500, 1000, 2000, 5000, 10000, 20000, std::numeric_limits<int>::max() };	//< Upper limits of the tick jitter histogram bins, in microseconds
 
+static_assert((SOURCE_ID_MAX - SOURCE_ID_MIN) < 64, "SourceIds of a device must fit into the bits of CController::m_sourceIdsInUse");
+
+
+/**
+ * Automation parameter addressed by each OSC command, see enum OscCommand. 
+ * For OscCmd_SourcePositionXY, this is the X coordinate, followed by ParamIdx_Y.
+ */
+static constexpr AutomationParameterIndex kOscCommandParamIndices[OscCmd_MaxIndex] = 
+{
+	ParamIdx_X,
+	ParamIdx_ReverbSendGain,
+	ParamIdx_SourceSpread,
+	ParamIdx_DelayMode
+};
+
+
+/**
+ * Change flag belonging to the parameter(s) addressed by each OSC command, see enum OscCommand.
+ */
+static constexpr DataChangeTypes kOscCommandChangeTypes[OscCmd_MaxIndex] = 
+{
+	DCT_SourcePosition,
+	DCT_ReverbSendGain,
+	DCT_SourceSpread,
+	DCT_DelayMode
+};
+
+
+/**
+ * Global settings with a generation counter each, see CController::PopGlobalChanges().
+ */
+static constexpr DataChangeTypes kGlobalSettings[CController::GLOBAL_SETTING_COUNT] = 
+{
+	DCT_NumPlugins,
+	DCT_IPAddress,
+	DCT_MessageRate,
+	DCT_Online,
+	DCT_RefreshInterval
+};
+static_assert((DCT_NumPlugins | DCT_IPAddress | DCT_MessageRate | DCT_Online | DCT_RefreshInterval) == DCT_GlobalSettings, 
+	"kGlobalSettings must cover DCT_GlobalSettings");
+
+
+/*
+===============================================================================
+ Class AChangeSubscriber
+===============================================================================
+*/
+
+/**
+ * Object constructor. The subscriber is not woken by anything until Subscribe() is called.
+ */
+AChangeSubscriber::AChangeSubscriber()
+	: m_interest(DCT_None),
+	m_plugin(nullptr),
+	m_subscribed(false)
+{
+}
+
+/**
+ * Object destructor.
+ * NOTE: Derived classes should call Unsubscribe() in their own destructor already, 
+ * so that ChangesPending() can not be triggered while they are being destroyed.
+ */
+AChangeSubscriber::~AChangeSubscriber()
+{
+	Unsubscribe();
+}
+
+/**
+ * Register interest in changes, or change the interest of an existing subscription. 
+ * Does not create the CController, since a GUI may outlive the last Plug-in. Must be called on the message thread.
+ * @param interest	Mask of the changes which should wake this subscriber.
+ * @param plugin	Plug-in whose changes should wake this subscriber, or nullptr for changes of all Plug-ins.
+ */
+void AChangeSubscriber::Subscribe(DataChangeTypes interest, const CPlugin* plugin)
+{
+	m_plugin = plugin;
+	m_interest = interest;
+
+	if (m_subscribed)
+		return;
+
+	CController* ctrl = CController::GetInstanceWithoutCreating();
+	if (ctrl == nullptr)
+		return;
+
+	ctrl->AddChangeSubscriber(this);
+	m_subscribed = true;
+}
+
+/**
+ * Stop being woken by changes, and discard a pending ChangesPending() call.
+ * Does not create the CController, i.e. when an editor is destroyed after the last Plug-in. Must be called on the message thread.
+ */
+void AChangeSubscriber::Unsubscribe()
+{
+	m_interest = DCT_None;
+	cancelPendingUpdate();
+
+	if (!m_subscribed)
+		return;
+
+	m_subscribed = false;
+
+	CController* ctrl = CController::GetInstanceWithoutCreating();
+	if (ctrl == nullptr)
+		return;
+
+	ctrl->RemoveChangeSubscriber(this);
+}
+
+/**
+ * Called by CController::NotifyChangeSubscribers(), possibly from any thread. 
+ * Schedules a ChangesPending() call if the changes match this subscriber's interest.
+ * @param plugin		The Plug-in whose data has changed, or nullptr for the CController's global settings.
+ * @param changeTypes	Defines which parameter or property has been changed.
+ */
+void AChangeSubscriber::Notify(const CPlugin* plugin, DataChangeTypes changeTypes)
+{
+	if ((changeTypes & m_interest.load()) == DCT_None)
+		return;
+
+	const CPlugin* subscribedPlugin = m_plugin.load();
+	if ((plugin == nullptr) || (subscribedPlugin == nullptr) || (plugin == subscribedPlugin))
+		triggerAsyncUpdate();
+}
+
+/**
+ * Reimplemented from AsyncUpdater, called on the message thread.
+ */
+void AChangeSubscriber::handleAsyncUpdate()
+{
+	ChangesPending();
+}
+
+
+/*
+===============================================================================
+ Class CProfiledMutex
+===============================================================================
+*/
+
+/**
+ * Object constructor.
+ */
+CProfiledMutex::CProfiledMutex()
+	: m_enterTicks(0)
+{
+	ResetProfile();
+}
+
+/**
+ * Object destructor.
+ */
+CProfiledMutex::~CProfiledMutex()
+{
+}
+
+/**
+ * Take the lock, waiting for the current holder if necessary. Must not be called by the current holder.
+ */
+void CProfiledMutex::enter() const
+{
+	int64 startTicks = Time::getHighResolutionTicks();
+	if (!m_mutex.try_lock())
+	{
+		m_mutex.lock();
+		m_contentions.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// From here on, this thread is the only one updating the statistics.
+	m_enterTicks = Time::getHighResolutionTicks();
+	int64 waitTicks = m_enterTicks - startTicks;
+	m_acquisitions.fetch_add(1, std::memory_order_relaxed);
+	m_waitTicks.fetch_add(waitTicks, std::memory_order_relaxed);
+	if (waitTicks > m_waitTicksMax.load(std::memory_order_relaxed))
+		m_waitTicksMax.store(waitTicks, std::memory_order_relaxed);
+}
 
 /**
- * Pre-defined OSC command and response strings
+ * Release the lock. Must be called by the current holder.
  */
-static const String kOscDelimiterString("/");
-static const String kOscCommandString_ping("/ping");
-static const String kOscCommandString_source_position_xy("/dbaudio1/coordinatemapping/source_position_xy/%d/%d");
-static const String kOscCommandString_reverbsendgain("/dbaudio1/matrixinput/reverbsendgain/%d");
-static const String kOscCommandString_source_spread("/dbaudio1/positioning/source_spread/%d");
-static const String kOscCommandString_source_delaymode("/dbaudio1/positioning/source_delaymode/%d");
-static const String kOscResponseString_pong("/pong");
-static const String kOscResponseString_source_position_xy("/dbaudio1/coordinatemapping/source_position_xy");
-static const String kOscResponseString_reverbsendgain("/dbaudio1/matrixinput/reverbsendgain");
-static const String kOscResponseString_source_spread("/dbaudio1/positioning/source_spread");
-static const String kOscResponseString_source_delaymode("/dbaudio1/positioning/source_delaymode");
+void CProfiledMutex::exit() const
+{
+	int64 holdTicks = Time::getHighResolutionTicks() - m_enterTicks;
+	m_holdTicks.fetch_add(holdTicks, std::memory_order_relaxed);
+	if (holdTicks > m_holdTicksMax.load(std::memory_order_relaxed))
+		m_holdTicksMax.store(holdTicks, std::memory_order_relaxed);
+
+	m_mutex.unlock();
+}
 
+/**
+ * Get the lock statistics. May be called from any thread. The values are read one by one, 
+ * so they might be off by a lock operation or two relative to each other.
+ * @return	The statistics since the last ResetProfile() call.
+ */
+CProfiledMutex::Profile CProfiledMutex::GetProfile() const
+{
+	const double microsecondsPerTick = Time::highResolutionTicksToSeconds(1) * 1000000.0;
 
+	Profile profile;
+	profile.acquisitions = m_acquisitions.load(std::memory_order_relaxed);
+	profile.contentions = m_contentions.load(std::memory_order_relaxed);
+	profile.waitTotal = m_waitTicks.load(std::memory_order_relaxed) * microsecondsPerTick;
+	profile.waitMax = m_waitTicksMax.load(std::memory_order_relaxed) * microsecondsPerTick;
+	profile.holdTotal = m_holdTicks.load(std::memory_order_relaxed) * microsecondsPerTick;
+	profile.holdMax = m_holdTicksMax.load(std::memory_order_relaxed) * microsecondsPerTick;
+
+	return profile;
+}
+
+/**
+ * Restart the lock statistics. May be called from any thread.
+ */
+void CProfiledMutex::ResetProfile()
+{
+	m_acquisitions = 0;
+	m_contentions = 0;
+	m_waitTicks = 0;
+	m_waitTicksMax = 0;
+	m_holdTicks = 0;
+	m_holdTicksMax = 0;
+}
+
+
+/*
+===============================================================================
+ Class CProcessorSnapshot
+===============================================================================
+*/
+
+/**
+ * Object constructor.
+ * @param processors	The registered Plug-ins, see CController::m_processors.
+ * @param processorIds	Their PluginIds, at the same indices.
+ */
+CProcessorSnapshot::CProcessorSnapshot(const Array<CPlugin*>& processors, const Array<PluginId>& processorIds)
+	: m_processors(processors),
+	m_processorIds(processorIds)
+{
+	jassert(m_processors.size() == m_processorIds.size());
+
+	for (int idx = 0; idx < m_processorIds.size(); ++idx)
+	{
+		int slot = m_processorIds[idx] & PLUGIN_ID_SLOT_MASK;
+		while (m_indexBySlot.size() <= slot)
+			m_indexBySlot.add(-1);
+		m_indexBySlot.set(slot, idx);
+	}
+}
+
+/**
+ * Object destructor.
+ */
+CProcessorSnapshot::~CProcessorSnapshot()
+{
+}
+
+/**
+ * Number of Plug-ins in this snapshot.
+ * @return	Number of Plug-ins which were registered when the snapshot was taken.
+ */
+int CProcessorSnapshot::GetProcessorCount() const
+{
+	return m_processors.size();
+}
+
+/**
+ * Get a pointer to a specified processor.
+ * @param idx	The index of the desired processor, between 0 and GetProcessorCount() - 1.
+ * @return	The pointer to the desired processor.
+ */
+CPlugin* CProcessorSnapshot::GetProcessor(int idx) const
+{
+	if ((idx >= 0) && (idx < m_processors.size()))
+		return m_processors[idx];
+
+	jassertfalse; // Index out of range!
+	return nullptr;
+}
+
+/**
+ * Get the PluginId of a specified processor.
+ * @param idx	The index of the desired processor, between 0 and GetProcessorCount() - 1.
+ * @return	The PluginId of the desired processor, or -1 if the index is out of range.
+ */
+PluginId CProcessorSnapshot::GetProcessorId(int idx) const
+{
+	if ((idx >= 0) && (idx < m_processorIds.size()))
+		return m_processorIds[idx];
+
+	jassertfalse; // Index out of range!
+	return -1;
+}
+
+/**
+ * Get a pointer to the processor with the given PluginId.
+ * @param pluginId	The PluginId of the desired processor.
+ * @return	The pointer to the desired processor, or nullptr if it was not registered when the snapshot was taken.
+ */
+CPlugin* CProcessorSnapshot::GetProcessorById(PluginId pluginId) const
+{
+	if (pluginId >= 0)
+	{
+		int slot = pluginId & PLUGIN_ID_SLOT_MASK;
+		if (slot < m_indexBySlot.size())
+		{
+			int idx = m_indexBySlot[slot];
+			if ((idx >= 0) && (m_processorIds[idx] == pluginId))
+				return m_processors[idx];
+		}
+	}
+
+	return nullptr;
+}
 
 
 /*
@@ -91,24 +397,38 @@ CController* CController::m_singleton = nullptr;
  * is managed from a central point and only one UDP port is opened for all OSC communication.
  */
 CController::CController()
+	: m_oscReceiveThread(this),
+	m_setDeadline([this] { SendQueuedSetCommands(); })
 {
 	jassert(!m_singleton);	// only one instnce allowed!!
 	m_singleton = this;
 
-	m_ipAddress = String("");
+	for (int q = 0; q < PQ_Max; q++)
+		m_queuedProcessors[q] = nullptr;
+	m_lowLatencyMode = false;
 	m_oscMsgRate = 0;
+	m_unmatchedDatagrams = 0;
+	m_unparsedMessages = 0;
+	m_rxDevice = nullptr;
+
+	m_lastTickTime = 0.0;
+	m_lastApplyTime = 0.0;
+	m_receivedValuesApplied = false;
+	ResetTickJitterHistogram();
 
 	// Clear all changed flags initially
 	for (int cs = 0; cs < DCS_Max; cs++)
 		m_parametersChanged[cs] = DCT_None;
-
-	// CController derives from OSCReceiver::Listener
-	m_oscReceiver.addListener(this); 
+	for (int gs = 0; gs < GLOBAL_SETTING_COUNT; gs++)
+		m_globalGenerations[gs] = 0;
+	for (DeviceId deviceId = 0; deviceId < DEVICE_COUNT_MAX; ++deviceId)
+		m_sourceIdsInUse[deviceId] = 0;
+	PublishProcessorSnapshot();
 
 	// Default OSC server settings. These might become overwritten 
 	// by setStateInformation()
-	SetRate(DCS_Osc, OSC_INTERVAL_DEF);
 	SetIpAddress(DCS_Osc, OSC_DEFAULT_IP);
+	SetRate(DCS_Osc, OSC_INTERVAL_DEF);
 }
 
 /**
@@ -116,7 +436,9 @@ CController::CController()
  */
 CController::~CController()
 {
+	m_setDeadline.SetEnabled(false);
 	stopTimer();
+	cancelPendingUpdate();
 	DisconnectOsc();
 
 	// Destroy overView window and overView Manager
@@ -124,258 +446,944 @@ CController::~CController()
 	if (ovrMgr)
 		ovrMgr->CloseOverview(true);
 
-	const ScopedLock lock(m_mutex);
-	m_processors.clearQuick();
+	const CProfiledMutex::ScopedLockType lock(m_registryMutex);
+	m_processors.clearQuick();
+	m_processorIds.clearQuick();
+	m_processorSlots.clearQuick();
+	m_freeProcessorSlots.clearQuick();
+	PublishProcessorSnapshot();
+
+	m_singleton = nullptr;
+}
+
+/**
+ * Returns the one and only instance of CController. If it doesn't exist yet, it is created.
+ * @return The CController singleton object.
+ * @sa m_singleton, CController
+ */
+CController* CController::GetInstance()
+{
+	if (m_singleton == nullptr)
+	{
+		m_singleton = new CController();
+	}
+	return m_singleton;
+}
+
+/**
+ * Returns the one and only instance of CController, without creating it if it doesn't exist yet.
+ * Unlike GetInstance(), this never allocates, so it may be used on the host's audio thread.
+ * @return The CController singleton object, or nullptr.
+ * @sa m_singleton, CController
+ */
+CController* CController::GetInstanceWithoutCreating()
+{
+	return m_singleton;
+}
+
+/**
+ * Method which will be called every time a parameter or property has been changed.
+ * @param changeSource	The application module which is causing the property change.
+ * @param changeTypes	Defines which parameter or property has been changed.
+ */
+void CController::SetParameterChanged(DataChangeSource changeSource, DataChangeTypes changeTypes)
+{
+	ignoreUnused(changeSource);
+
+	// Only global settings are flagged here. Changes concerning a single Plug-in are flagged on the Plug-in itself.
+	jassert((changeTypes & ~DCT_GlobalSettings) == DCT_None);
+
+	// Set the specified change flag for all DataChangeSources.
+	for (int cs = 0; cs < DCS_Max; cs++)
+	{
+		m_parametersChanged[cs].fetch_or(changeTypes);
+	}
+
+	// Publish the change to the Plug-ins' GUIs by advancing the setting's generation, rather than 
+	// forwarding the flag to every Plug-in instance. See PopGlobalChanges().
+	for (int gs = 0; gs < GLOBAL_SETTING_COUNT; gs++)
+	{
+		if ((changeTypes & kGlobalSettings[gs]) != DCT_None)
+			m_globalGenerations[gs].fetch_add(1);
+	}
+
+	NotifyChangeSubscribers(nullptr, changeTypes);
+}
+
+/**
+ * Register a GUI component to be woken when data changes. Registering the same subscriber twice has no effect.
+ * @param subscriber	The subscriber to add. See AChangeSubscriber::Subscribe().
+ */
+void CController::AddChangeSubscriber(AChangeSubscriber* subscriber)
+{
+	const ScopedLock lock(m_subscriberMutex);
+	m_changeSubscribers.addIfNotAlreadyThere(subscriber);
+}
+
+/**
+ * Unregister a GUI component, so that it is no longer woken when data changes.
+ * @param subscriber	The subscriber to remove. See AChangeSubscriber::Unsubscribe().
+ */
+void CController::RemoveChangeSubscriber(AChangeSubscriber* subscriber)
+{
+	const ScopedLock lock(m_subscriberMutex);
+	m_changeSubscribers.removeFirstMatchingValue(subscriber);
+}
+
+/**
+ * Wake all subscribers which are interested in the given changes. May be called from any thread.
+ * @param plugin		The Plug-in whose data has changed, or nullptr for the CController's global settings.
+ * @param changeTypes	Defines which parameter or property has been changed.
+ */
+void CController::NotifyChangeSubscribers(const CPlugin* plugin, DataChangeTypes changeTypes)
+{
+	const ScopedLock lock(m_subscriberMutex);
+	for (int i = 0; i < m_changeSubscribers.size(); ++i)
+		m_changeSubscribers.getUnchecked(i)->Notify(plugin, changeTypes);
+}
+
+/**
+ * Check which global settings have changed since the consumer last called this method,
+ * and remember their current generations as seen.
+ * @param lastSeen	The generations which the consumer has last seen. Updated to the current ones.
+ * @return	The global settings (see DCT_GlobalSettings) which have changed since.
+ */
+DataChangeTypes CController::PopGlobalChanges(GlobalGenerations& lastSeen) const
+{
+	DataChangeTypes changes = DCT_None;
+	for (int gs = 0; gs < GLOBAL_SETTING_COUNT; gs++)
+	{
+		uint32 generation = m_globalGenerations[gs].load();
+		if (generation != lastSeen.generation[gs])
+		{
+			lastSeen.generation[gs] = generation;
+			changes |= kGlobalSettings[gs];
+		}
+	}
+
+	return changes;
+}
+
+/**
+ * Get the state of the desired flag (or flags) for the desired change source.
+ * @param changeSource	The application module querying the change flag.
+ * @param change		The desired parameter (or parameters).
+ * @return	True if any of the given parameters has changed it's value 
+ *			since the last time PopParameterChanged() was called.
+ */
+bool CController::GetParameterChanged(DataChangeSource changeSource, DataChangeTypes change)
+{
+	return ((m_parametersChanged[changeSource].load() & change) != 0);
+}
+
+/**
+ * Reset the state of the desired flag (or flags) for the desired change source.
+ * Will return the state of the flag before the resetting.
+ * @param changeSource	The application module querying the change flag.
+ * @param change		The desired parameter (or parameters).
+ * @return	The state of the flag before the resetting.
+ */
+bool CController::PopParameterChanged(DataChangeSource changeSource, DataChangeTypes change)
+{
+	// Reset flag, and check its state before resetting in the same atomic operation.
+	DataChangeTypes previous = m_parametersChanged[changeSource].fetch_and(~change);
+	return ((previous & change) != 0);
+}
+
+/**
+ * Register a plugin instance to the local list of processors. 
+ * @param p		Pointer to newly crated plugin processor object.
+ * @return		The PluginId of the newly added Plug-in. It remains valid until the Plug-in is removed.
+ */
+PluginId CController::AddProcessor(CPlugin* p)
+{
+	PluginId newPluginId;
+	SourceId newSourceId;
+
+	{ // Scope for lock.
+		const CProfiledMutex::ScopedLockType lock(m_registryMutex);
+
+		// Pick the lowest SourceId which is not yet used on the same device.
+		// SourceIds are counted separately for each device, since each DS100 has its own matrix inputs.
+		newSourceId = GetFreeSourceId(p->GetDeviceId());
+		if (newSourceId == INVALID_SOURCE_ID)
+		{
+			// More Plug-ins than matrix inputs. The new one shares the highest SourceId, which the 
+			// Overview flags as shared, see IsSourceIdShared(). The user needs to reassign it.
+			DBG("CController::AddProcessor: no free SourceId, sharing " + String(SOURCE_ID_MAX));
+			newSourceId = SOURCE_ID_MAX;
+		}
+
+		// Reuse a free slot of the slot map if possible. Its generation was advanced when it was freed.
+		int slot;
+		if (m_freeProcessorSlots.isEmpty())
+		{
+			slot = m_processorSlots.size();
+			jassert(slot <= PLUGIN_ID_SLOT_MASK); // Too many Plug-in instances!
+			m_processorSlots.add(ProcessorSlot());
+		}
+		else
+		{
+			slot = m_freeProcessorSlots.getLast();
+			m_freeProcessorSlots.removeLast();
+		}
+
+		ProcessorSlot& entry = m_processorSlots.getReference(slot);
+		newPluginId = (entry.generation << PLUGIN_ID_SLOT_BITS) | slot;
+		entry.processor = p;
+		entry.index = m_processors.size();
+
+		m_processors.add(p);
+		m_processorIds.add(newPluginId);
+		PublishProcessorSnapshot();
+
+		// Route the new Plug-in by the SourceId it is about to get, and reserve that SourceId right away. 
+		// The SetSourceId() call below then finds the Plug-in on the route of its new SourceId already.
+		GetSourceRoute(p->GetDeviceId(), newSourceId).add(p);
+		UpdateSourceIdInUse(p->GetDeviceId(), newSourceId);
+	}
+
+	SetParameterChanged(DCS_Osc, DCT_NumPlugins);
+
+	// Visit the new Plug-in during the next tick, so that it can start polling if necessary.
+	QueueProcessorForTick(p);
+
+	// Set the new Plugin's InputID to the first free one. This takes m_registryMutex itself, see UpdateSourceRoute().
+	p->SetSourceId(DCS_Osc, newSourceId);
+
+#ifdef DB_SHOW_DEBUG
+	p->PushDebugMessage(String::formatted("++ CController::AddProcessor: pId=%d ++", newPluginId));
+#endif
+
+	return newPluginId;
+}
+
+/**
+ * Remove a plugin instance from the local list of processors.
+ * @param p		Pointer to plugin processor object which should be removed.
+ */
+void CController::RemoveProcessor(CPlugin* p)
+{
+	if (GetProcessorCount() > 1)
+	{
+		// The timer tick must not be visiting the Plug-in while it is removed.
+		const CProfiledMutex::ScopedLockType sendLock(m_sendMutex);
+		const CProfiledMutex::ScopedLockType registryLock(m_registryMutex);
+
+		// Resolve the Plug-in's slot through its PluginId.
+		int slot = p->GetPluginId() & PLUGIN_ID_SLOT_MASK;
+		int idx = -1;
+		if ((p->GetPluginId() >= 0) && (slot < m_processorSlots.size()) && (m_processorSlots[slot].processor == p))
+			idx = m_processorSlots[slot].index;
+
+		jassert(idx >= 0); // Tried to remove inexistent plugin object.
+		if (idx >= 0)
+		{
+			// Keep m_processors dense by moving its last entry into the gap.
+			int lastIdx = m_processors.size() - 1;
+			if (idx != lastIdx)
+			{
+				PluginId movedId = m_processorIds[lastIdx];
+				m_processors.set(idx, m_processors[lastIdx]);
+				m_processorIds.set(idx, movedId);
+				m_processorSlots.getReference(movedId & PLUGIN_ID_SLOT_MASK).index = idx;
+			}
+			m_processors.removeLast();
+			m_processorIds.removeLast();
+			PublishProcessorSnapshot();
+
+			// Advance the slot's generation, so that the removed Plug-in's PluginId no longer resolves.
+			ProcessorSlot& entry = m_processorSlots.getReference(slot);
+			entry.processor = nullptr;
+			entry.index = -1;
+			entry.generation = (entry.generation + 1) & PLUGIN_ID_GENERATION_MASK;
+			m_freeProcessorSlots.add(slot);
+
+			GetSourceRoute(p->GetDeviceId(), p->GetSourceId()).removeFirstMatchingValue(p);
+			UpdateSourceIdInUse(p->GetDeviceId(), p->GetSourceId());
+			UnqueueProcessor(p);
+
+			SetParameterChanged(DCS_Osc, DCT_NumPlugins);
+		}
+	}
+
+	// If last plugin instance is being removed, delete CController singleton.
+	else if (GetProcessorCount() == 1)
+	{
+		{ // Scope for lock.
+			const CProfiledMutex::ScopedLockType sendLock(m_sendMutex);
+			const CProfiledMutex::ScopedLockType registryLock(m_registryMutex);
+			m_processors.clearQuick();
+			m_processorIds.clearQuick();
+			PublishProcessorSnapshot();
+			UnqueueProcessor(p);
+		}
+	
+		delete this;
+	}
+}
+
+/**
+ * Move a plugin instance to the routing table entry of its current device and SourceId. 
+ * Must be called whenever either of them changes, see CPlugin::SetSourceId() and CPlugin::SetDeviceId().
+ * @param p				Pointer to plugin processor object which was re-assigned.
+ * @param oldDeviceId	Device to which the Plug-in was bound before.
+ * @param oldSourceId	SourceId which the Plug-in had before.
+ */
+void CController::UpdateSourceRoute(CPlugin* p, DeviceId oldDeviceId, SourceId oldSourceId)
+{
+	const CProfiledMutex::ScopedLockType lock(m_registryMutex);
+
+	// Plug-ins which are still being constructed are not routed yet, see AddProcessor().
+	Array<CPlugin*>& oldRoute = GetSourceRoute(oldDeviceId, oldSourceId);
+	int idx = oldRoute.indexOf(p);
+	if (idx >= 0)
+	{
+		oldRoute.remove(idx);
+		GetSourceRoute(p->GetDeviceId(), p->GetSourceId()).add(p);
+
+		UpdateSourceIdInUse(oldDeviceId, oldSourceId);
+		UpdateSourceIdInUse(p->GetDeviceId(), p->GetSourceId());
+	}
+}
+
+/**
+ * Check if more than one Plug-in is bound to the given SourceId, in which case they all poll and control
+ * the same matrix input of the DS100. Used by the overview to flag such collisions.
+ * @param deviceId	Device on which to look.
+ * @param sourceId	SourceId to look for.
+ * @return	True if the SourceId is used by several Plug-ins.
+ */
+bool CController::IsSourceIdShared(DeviceId deviceId, SourceId sourceId) const
+{
+	const CProfiledMutex::ScopedLockType lock(m_registryMutex);
+	if (IsValidDeviceId(deviceId) && (sourceId >= SOURCE_ID_MIN) && (sourceId <= SOURCE_ID_MAX))
+		return (m_sourceRoutes[deviceId][sourceId - SOURCE_ID_MIN].size() > 1);
+
+	return false;
+}
+
+/**
+ * Get the routing table entry for the given device and SourceId.
+ * Must be called with m_registryMutex held.
+ * @param deviceId	Index of the desired device.
+ * @param sourceId	The desired SourceId.
+ * @return	The Plug-ins bound to this SourceId of this device.
+ */
+Array<CPlugin*>& CController::GetSourceRoute(DeviceId deviceId, SourceId sourceId)
+{
+	jassert(IsValidDeviceId(deviceId));
+	jassert((sourceId >= SOURCE_ID_MIN) && (sourceId <= SOURCE_ID_MAX));
+	return m_sourceRoutes[deviceId][sourceId - SOURCE_ID_MIN];
+}
+
+/**
+ * Update the occupancy bit of a SourceId after its routing table entry has changed. Must be called with m_registryMutex held.
+ * @param deviceId	Device of the SourceId in question.
+ * @param sourceId	The SourceId in question.
+ */
+void CController::UpdateSourceIdInUse(DeviceId deviceId, SourceId sourceId)
+{
+	uint64 bit = static_cast<uint64>(1) << (sourceId - SOURCE_ID_MIN);
+	if (GetSourceRoute(deviceId, sourceId).isEmpty())
+		m_sourceIdsInUse[deviceId] &= ~bit;
+	else
+		m_sourceIdsInUse[deviceId] |= bit;
+}
+
+/**
+ * Find the lowest SourceId on the given device to which no Plug-in is bound yet. Must be called with m_registryMutex held.
+ * @param deviceId	Device on which to look.
+ * @return	The lowest free SourceId, or INVALID_SOURCE_ID if all of them are in use.
+ */
+SourceId CController::GetFreeSourceId(DeviceId deviceId) const
+{
+	// Isolate the lowest clear bit, then find its position.
+	uint64 inUse = m_sourceIdsInUse[deviceId];
+	uint64 lowestFree = ~inUse & (inUse + 1);
+	if (lowestFree == 0)
+		return INVALID_SOURCE_ID;
+
+	int bit;
+	if (static_cast<uint32>(lowestFree) != 0)
+		bit = findHighestSetBit(static_cast<uint32>(lowestFree));
+	else
+		bit = 32 + findHighestSetBit(static_cast<uint32>(lowestFree >> 32));
+
+	// The mask has room for 64 SourceIds, which may be more than there are.
+	SourceId sourceId = SOURCE_ID_MIN + bit;
+	if (sourceId > SOURCE_ID_MAX)
+		return INVALID_SOURCE_ID;
+
+	return sourceId;
+}
+
+/**
+ * Add a plugin instance to the list of processors which are visited during the next timer tick.
+ * The list is intrusive and lock-free, so this may be called from any thread, i.e. also from within 
+ * the host's automation callbacks. Adding a processor which is already on the list has no effect.
+ * @param p		Pointer to plugin processor object which should be visited.
+ */
+void CController::QueueProcessorForTick(CPlugin* p)
+{
+	if (p->MarkQueued(PQ_Tick))
+		PushQueuedProcessor(PQ_Tick, p);
+}
+
+/**
+ * In low-latency mode, add a plugin instance with locally changed parameters to the list of processors
+ * whose SET commands are sent out once the low-latency deadline expires, and arm the deadline.
+ * Otherwise, the changes are sent out during the next timer tick as usual. May be called from any thread.
+ * @param p		Pointer to plugin processor object with changed parameters.
+ */
+void CController::QueueProcessorForSet(CPlugin* p)
+{
+	if (m_lowLatencyMode)
+	{
+		if (p->MarkQueued(PQ_Set))
+			PushQueuedProcessor(PQ_Set, p);
+		m_setDeadline.Arm(SET_DEADLINE);
+	}
+}
+
+/**
+ * Push a plugin instance onto one of the m_queuedProcessors lists. The caller must have set its queued flag.
+ * @param queue	The list to push onto.
+ * @param p		Pointer to plugin processor object which should be visited.
+ */
+void CController::PushQueuedProcessor(ProcessorQueue queue, CPlugin* p)
+{
+	CPlugin* head = m_queuedProcessors[queue].load(std::memory_order_relaxed);
+	do
+	{
+		p->SetNextQueued(queue, head);
+	} while (!m_queuedProcessors[queue].compare_exchange_weak(head, p, std::memory_order_release, std::memory_order_relaxed));
+}
+
+/**
+ * Take a plugin instance off all lists of processors to visit, i.e. before it is destroyed.
+ * Must be called while holding m_sendMutex, so that the lists aren't being consumed at the same time.
+ * @param p		Pointer to plugin processor object which should not be visited anymore.
+ */
+void CController::UnqueueProcessor(CPlugin* p)
+{
+	for (int q = 0; q < PQ_Max; q++)
+	{
+		ProcessorQueue queue = static_cast<ProcessorQueue>(q);
+		CPlugin* queued = m_queuedProcessors[queue].exchange(nullptr, std::memory_order_acquire);
+		while (queued != nullptr)
+		{
+			CPlugin* next = queued->GetNextQueued(queue);
+			if (queued == p)
+				queued->ClearQueued(queue);
+			else
+				PushQueuedProcessor(queue, queued);
+			queued = next;
+		}
+	}
+}
+
+/**
+ * Number of registered plugin instances.
+ * @return	Number of registered plugin instances.
+ */
+int CController::GetProcessorCount() const
+{
+	return GetProcessorSnapshot()->GetProcessorCount();
+}
+
+/**
+ * Get a pointer to a specified processor. Used to iterate over all registered processors. 
+ * Indices are not stable, since removing a processor moves another one into its place.
+ * To iterate over several processors, use GetProcessorSnapshot() instead, which returns a consistent list.
+ * @param idx	The index of the desired processor, between 0 and GetProcessorCount() - 1.
+ * @return	The pointer to the desired processor.
+ */
+CPlugin* CController::GetProcessor(int idx) const
+{
+	return GetProcessorSnapshot()->GetProcessor(idx);
+}
+
+/**
+ * Get the PluginId of a specified processor, which remains valid while the processor is registered.
+ * @param idx	The index of the desired processor, between 0 and GetProcessorCount() - 1.
+ * @return	The PluginId of the desired processor, or -1 if the index is out of range.
+ */
+PluginId CController::GetProcessorId(int idx) const
+{
+	return GetProcessorSnapshot()->GetProcessorId(idx);
+}
+
+/**
+ * Get a pointer to the processor with the given PluginId.
+ * @param pluginId	The PluginId of the desired processor, see AddProcessor() and GetProcessorId().
+ * @return	The pointer to the desired processor, or nullptr if it has been removed in the meantime.
+ */
+CPlugin* CController::GetProcessorById(PluginId pluginId) const
+{
+	return GetProcessorSnapshot()->GetProcessorById(pluginId);
+}
+
+/**
+ * Get the current list of registered processors. The returned snapshot does not change, even if processors
+ * are added or removed in the meantime, so it can be iterated over without locking. 
+ * Only hold on to it for the duration of one GUI update, since removed processors will be destroyed.
+ * @return	The snapshot of the registered processors. Never nullptr.
+ */
+CProcessorSnapshot::Ptr CController::GetProcessorSnapshot() const
+{
+	const SpinLock::ScopedLockType lock(m_processorSnapshotLock);
+	return m_processorSnapshot;
+}
+
+/**
+ * Replace the snapshot returned by GetProcessorSnapshot() with a copy of the current list of processors.
+ * Must be called with m_registryMutex held, whenever m_processors has changed. Readers which still hold the 
+ * previous snapshot keep using it, it is deleted once the last of them lets go.
+ */
+void CController::PublishProcessorSnapshot()
+{
+	CProcessorSnapshot::Ptr snapshot(new CProcessorSnapshot(m_processors, m_processorIds));
+
+	// The previous snapshot is released outside of the lock, in case this was the last reference.
+	{
+		const SpinLock::ScopedLockType lock(m_processorSnapshotLock);
+		std::swap(m_processorSnapshot, snapshot);
+	}
+}
+
+/**
+ * Getter function for the IP address of one of the DS100 devices.
+ * @param deviceId	Index of the device within the device table.
+ * @return	Current IP address, or an empty string if the device is unused.
+ */
+String CController::GetIpAddress(DeviceId deviceId) const
+{
+	if (!IsValidDeviceId(deviceId))
+		return String();
+
+	const CProfiledMutex::ScopedLockType lock(m_registryMutex);
+	return m_ipAddresses[deviceId];
+}
+
+/**
+ * Static methiod which returns the default IP address.
+ * @return	IP address to use as default.
+ */
+String CController::GetDefaultIpAddress()
+{
+	return OSC_DEFAULT_IP;
+}
+
+/**
+ * Setter function for the IP address of one of the DS100 devices.
+ * NOTE: changing ip address will reconnect the device's sending socket. Host names are resolved
+ * right away, which may block the calling thread, but not the timer tick.
+ * @param changeSource	The application module which is causing the property change.
+ * @param ipAddress		New IP address or host name, or an empty string to leave the device unused.
+ * @param deviceId		Index of the device within the device table.
+ */
+void CController::SetIpAddress(DataChangeSource changeSource, String ipAddress, DeviceId deviceId)
+{
+	if (IsValidDeviceId(deviceId) && (GetIpAddress(deviceId) != ipAddress))
+	{
+		// Resolve before locking, replies can only be assigned to the device once its address is known.
+		uint32 rxAddress = CDevice::ResolveRxAddress(ipAddress);
+		if (ipAddress.isNotEmpty() && (rxAddress == 0))
+			DBG("CController::SetIpAddress: could not resolve " + ipAddress);
+
+		const CProfiledMutex::ScopedLockType lock(m_sendMutex);
+
+		// Starts "offline", and reconnects the device at its new address.
+		m_devices[deviceId].SetIpAddress(ipAddress, rxAddress);
+
+		{ // Scope for lock, see m_ipAddresses.
+			const CProfiledMutex::ScopedLockType registryLock(m_registryMutex);
+			m_ipAddresses[deviceId] = ipAddress;
+		}
+
+		// Replies from all devices arrive on the same socket.
+		if (!m_oscReceiveThread.IsRunning())
+		{
+			bool ok = m_oscReceiveThread.Start(RX_PORT_HOST);
+			jassert(ok);
+			ignoreUnused(ok);
+		}
+
+		// Signal the change to all plugins. 
+		SetParameterChanged(changeSource, (DCT_IPAddress | DCT_Online));
+	}
+}
+
+/**
+ * Find the device entry which uses the given IP address. Does not lock, so that it can be used on the receive thread.
+ * @param senderAddress	IPv4 address to look for in host byte order, i.e. the sender of a received OSC message.
+ * @return	Index of the device within the device table, or -1 if no device uses this address.
+ */
+DeviceId CController::FindDevice(uint32 senderAddress) const
+{
+	for (DeviceId deviceId = 0; deviceId < DEVICE_COUNT_MAX; ++deviceId)
+	{
+		if (m_devices[deviceId].HasAddress(senderAddress))
+			return deviceId;
+	}
+
+	return -1;
+}
+
+/**
+ * Find the device entry to which datagrams from unknown senders are assigned. Does not lock, 
+ * so that it can be used on the receive thread.
+ * @return	Index of the only device which has an IP address, or -1 if none or several devices are in use.
+ */
+DeviceId CController::GetOnlyUsedDevice() const
+{
+	DeviceId usedDeviceId = -1;
+	for (DeviceId deviceId = 0; deviceId < DEVICE_COUNT_MAX; ++deviceId)
+	{
+		if (m_devices[deviceId].IsUsed())
+		{
+			if (usedDeviceId >= 0)
+				return -1;
+			usedDeviceId = deviceId;
+		}
+	}
+
+	return usedDeviceId;
+}
+
+/**
+ * Getter for the number of received datagrams whose sender did not match any device's IP address.
+ * @return	Number of unmatched datagrams since the CController was created.
+ */
+int CController::GetUnmatchedDatagramCount() const
+{
+	return m_unmatchedDatagrams;
+}
+
+/**
+ * Getter for the number of received messages whose address pattern is not one of the dbaudio1 replies 
+ * handled by COscAddressParser, or whose IDs were out of range.
+ * @return	Number of unparsed messages since the CController was created.
+ */
+int CController::GetUnparsedMessageCount() const
+{
+	return m_unparsedMessages;
+}
+
+/**
+ * Check whether the given index refers to an entry of the device table.
+ * @param deviceId	Index to check.
+ * @return	True if the index is within 0 and DEVICE_COUNT_MAX - 1.
+ */
+bool CController::IsValidDeviceId(DeviceId deviceId)
+{
+	return ((deviceId >= 0) && (deviceId < DEVICE_COUNT_MAX));
+}
+
+/**
+ * Getter function for the OSC communication state of one of the DS100 devices.
+ * @param deviceId	Index of the device within the device table.
+ * @return		True if a valid OSC message was received from the device and successfully processed recently.
+ *				False if no response was received for longer than the timeout threshold.
+ */
+bool CController::GetOnline(DeviceId deviceId) const
+{
+	if (!IsValidDeviceId(deviceId))
+		return false;
+
+	return m_devices[deviceId].GetOnline(m_oscMsgRate);
+}
+
+/**
+ * Getter for the rate at which OSC messages are being sent out.
+ * @return	Messaging rate, in milliseconds.
+ */
+int CController::GetRate() const
+{
+	return m_oscMsgRate;
+}
+
+/**
+ * Setter for the rate at which OSC messages are being sent out.
+ * @param changeSource	The application module which is causing the property change.
+ * @param rate	New messaging rate, in milliseconds.
+ */
+void CController::SetRate(DataChangeSource changeSource, int rate)
+{
+	if (rate != m_oscMsgRate)
+	{
+		{ // Scope for lock.
+			const CProfiledMutex::ScopedLockType lock(m_sendMutex);
+
+			// Clip rate to the allowed range.
+			rate = jmin(OSC_INTERVAL_MAX, jmax(OSC_INTERVAL_MIN, rate));
+
+			m_oscMsgRate = rate;
+
+			// Signal the change to all plugins.
+			SetParameterChanged(changeSource, DCT_MessageRate);
+		}
+
+		// Reset timer to the new interval. This must happen without holding m_sendMutex, since restarting
+		// the HighResolutionTimer waits for a running hiResTimerCallback() to complete.
+		startTimer(rate);
+		ResetTickJitterHistogram();
+	}
+}
 
-	m_singleton = nullptr;
+/**
+ * Getter for the request budget towards one of the DS100 devices.
+ * @param deviceId	Index of the device within the device table.
+ * @return	Maximum number of OSC messages sent per second, of which GET commands may use whatever SET commands leave over.
+ */
+int CController::GetPollBudget(DeviceId deviceId) const
+{
+	if (!IsValidDeviceId(deviceId))
+		return 0;
+
+	return m_devices[deviceId].GetPollBudget();
 }
 
 /**
- * Returns the one and only instance of CController. If it doesn't exist yet, it is created.
- * @return The CController singleton object.
- * @sa m_singleton, CController
+ * Setter for the request budget towards one of the DS100 devices. GET commands of all polling Plug-ins bound to 
+ * the device are spread over several timer ticks if necessary, so that the total message rate stays within this budget.
+ * SET commands are never held back.
+ * @param budget	Maximum number of OSC messages per second.
+ * @param deviceId	Index of the device within the device table.
  */
-CController* CController::GetInstance()
+void CController::SetPollBudget(int budget, DeviceId deviceId)
 {
-	if (m_singleton == nullptr)
+	if (IsValidDeviceId(deviceId))
 	{
-		m_singleton = new CController();
+		const CProfiledMutex::ScopedLockType lock(m_sendMutex);
+		m_devices[deviceId].SetPollBudget(budget);
 	}
-	return m_singleton;
 }
 
 /**
- * Method which will be called every time a parameter or property has been changed.
- * @param changeSource	The application module which is causing the property change.
- * @param changeTypes	Defines which parameter or property has been changed.
+ * Effective interval at which the parameters of each polling source are requested from one of the DS100 devices.
+ * This is the timer interval as long as the device's request budget suffices, and grows once GET commands 
+ * need to be spread over multiple timer ticks.
+ * @param deviceId	Index of the device within the device table.
+ * @return	Refresh interval in milliseconds, or 0 if no Plug-in bound to the device is currently polling.
  */
-void CController::SetParameterChanged(DataChangeSource changeSource, DataChangeTypes changeTypes)
+int CController::GetPollRefreshInterval(DeviceId deviceId) const
 {
-	const ScopedLock lock(m_mutex);
-
-	// Set the specified change flag for all DataChangeSources, except for the one causing the change.
-	for (int cs = 0; cs < DCS_Max; cs++)
-	{
-		m_parametersChanged[cs] |= changeTypes;
-	}
+	if (!IsValidDeviceId(deviceId))
+		return 0;
 
-	// Forward the change to all plugin instances. This is needed, for example, so that all plugin's
-	// GUIs update an IP address change.
-	for (int i = 0; i < m_processors.size(); ++i)
-	{
-		m_processors[i]->SetParameterChanged(changeSource, changeTypes);
-	}
+	return m_devices[deviceId].GetPollRefreshInterval();
 }
 
 /**
- * Get the state of the desired flag (or flags) for the desired change source.
- * @param changeSource	The application module querying the change flag.
- * @param change		The desired parameter (or parameters).
- * @return	True if any of the given parameters has changed it's value 
- *			since the last time PopParameterChanged() was called.
+ * Static methiod which returns the allowed minimum and maximum OSC message rates.
+ * @return	Returns a std::pair<int, int> where the first number is the minimum supported rate, 
+ *			and the second number is the maximum.
  */
-bool CController::GetParameterChanged(DataChangeSource changeSource, DataChangeTypes change)
+std::pair<int, int> CController::GetSupportedRateRange()
 {
-	const ScopedLock lock(m_mutex);
-	return ((m_parametersChanged[changeSource] & change) != 0);
+	return std::pair<int, int>(OSC_INTERVAL_MIN, OSC_INTERVAL_MAX);
 }
 
 /**
- * Reset the state of the desired flag (or flags) for the desired change source.
- * Will return the state of the flag before the resetting.
- * @param changeSource	The application module querying the change flag.
- * @param change		The desired parameter (or parameters).
- * @return	The state of the flag before the resetting.
+ * Getter for the low-latency mode.
+ * @return	True if local parameter changes are sent out shortly after they happen, rather than at the next timer tick.
  */
-bool CController::PopParameterChanged(DataChangeSource changeSource, DataChangeTypes change)
+bool CController::GetLowLatencyMode() const
 {
-	const ScopedLock lock(m_mutex);
-	bool ret((m_parametersChanged[changeSource] & change) != 0);
-	m_parametersChanged[changeSource] &= ~change; // Reset flag.
-	return ret;
+	return m_lowLatencyMode;
 }
 
 /**
- * Register a plugin instance to the local list of processors. 
- * @param p		Pointer to newly crated plugin processor object.
- * @return		The PluginId of the newly added Plug-in.
+ * Setter for the low-latency mode. When enabled, a local parameter change arms a short deadline (SET_DEADLINE), 
+ * after which the latest values of all changed parameters are sent out. Further changes before the deadline expires
+ * are merged into the same SET commands. Each source sends at most one set of SET commands per SET_INTERVAL_MIN.
+ * NOTE: Must be called from the message thread, without holding m_sendMutex.
+ * @param enabled	True to enable low-latency mode.
  */
-PluginId CController::AddProcessor(CPlugin* p)
+void CController::SetLowLatencyMode(bool enabled)
 {
-	const ScopedLock lock(m_mutex);
-
-	// Get the highest Input number of all current Plugins.
-	SourceId currentMaxSourceId = 0;
-	for (int i = 0; i < m_processors.size(); ++i)
-	{
-		if (m_processors[i]->GetSourceId() > currentMaxSourceId)
-			currentMaxSourceId = m_processors[i]->GetSourceId();
-	}
-
-	m_processors.add(p);
-	SetParameterChanged(DCS_Osc, DCT_NumPlugins);
-
-	// Set the new Plugin's InputID to the next in sequence.
-	p->SetSourceId(DCS_Osc, currentMaxSourceId + 1);
-
-	PluginId newPluginId = static_cast<PluginId>(m_processors.size() - 1);
-#ifdef DB_SHOW_DEBUG
-	p->PushDebugMessage(String::formatted("++ CController::AddProcessor: pId=%d ++", newPluginId));
-#endif
-
-	return newPluginId;
+	m_lowLatencyMode = enabled;
+	m_setDeadline.SetEnabled(enabled);
 }
 
 /**
- * Remove a plugin instance from the local list of processors.
- * @param p		Pointer to plugin processor object which should be removed.
+ * Getter for the maximum size of UDP datagrams sent to one of the DS100 devices.
+ * @param deviceId	Index of the device within the device table.
+ * @return	Maximum datagram size, in bytes.
  */
-void CController::RemoveProcessor(CPlugin* p)
+int CController::GetMtu(DeviceId deviceId) const
 {
-	if (m_processors.size() > 1)
-	{
-		int idx = m_processors.indexOf(p);
-		jassert(idx >= 0); // Tried to remove inexistent plugin object.
-		if (idx >= 0)
-		{
-			const ScopedLock lock(m_mutex);
-			m_processors.remove(idx);
+	if (!IsValidDeviceId(deviceId))
+		return 0;
 
-			SetParameterChanged(DCS_Osc, DCT_NumPlugins);
-		}
-	}
+	const CProfiledMutex::ScopedLockType lock(m_sendMutex);
+	return m_devices[deviceId].GetMtu();
+}
 
-	// If last plugin instance is being removed, delete CController singleton.
-	else if (m_processors.size() == 1)
+/**
+ * Setter for the maximum size of UDP datagrams sent to one of the DS100 devices. All OSC messages generated 
+ * for the device during one timer tick are packed into as few OSC bundles as possible, none of which will exceed this size.
+ * @param mtu		New maximum datagram size, in bytes.
+ * @param deviceId	Index of the device within the device table.
+ */
+void CController::SetMtu(int mtu, DeviceId deviceId)
+{
+	if (IsValidDeviceId(deviceId))
 	{
-		{ // Scope for lock.
-			const ScopedLock lock(m_mutex);
-			m_processors.clearQuick();
-		}
-	
-		delete this;
+		const CProfiledMutex::ScopedLockType lock(m_sendMutex);
+		m_devices[deviceId].SetMtu(mtu);
 	}
 }
 
 /**
- * Number of registered plugin instances.
- * @return	Number of registered plugin instances.
+ * Number of UDP datagrams (OSC bundles, or single OSC messages) which were sent out to one of the 
+ * DS100 devices during the last timer tick.
+ * @param deviceId	Index of the device within the device table.
+ * @return	Number of datagrams sent during the last tick.
  */
-int CController::GetProcessorCount() const
+int CController::GetTxPacketsPerTick(DeviceId deviceId) const
 {
-	const ScopedLock lock(m_mutex);
-	return m_processors.size();
+	if (!IsValidDeviceId(deviceId))
+		return 0;
+
+	return m_devices[deviceId].GetTxPacketsPerTick();
 }
 
 /**
- * Get a pointer to a specified processor.
- * @param idx	The index of the desired processor.
- * @return	The pointer to the desired processor.
+ * Number of OSC messages (SET and GET commands, pings) which were sent out to one of the 
+ * DS100 devices during the last timer tick.
+ * @param deviceId	Index of the device within the device table.
+ * @return	Number of messages sent during the last tick.
  */
-CPlugin* CController::GetProcessor(PluginId idx) const
+int CController::GetTxMessagesPerTick(DeviceId deviceId) const
 {
-	const ScopedLock lock(m_mutex);
-	if ((idx >= 0) && (idx < m_processors.size()))
-		return m_processors[idx];
+	if (!IsValidDeviceId(deviceId))
+		return 0;
 
-	jassertfalse; // Index out of range!
-	return nullptr;
+	return m_devices[deviceId].GetTxMessagesPerTick();
 }
 
 /**
- * Getter function for the IP address to which m_oscSender and m_oscReceiver are connected.
- * @return	Current IP address.
+ * Upper limit of one bin of the tick jitter histogram.
+ * @param bin	Histogram bin, 0 to TICK_JITTER_BINS - 1.
+ * @return	Largest deviation from the nominal tick interval which is counted in this bin, in microseconds.
  */
-String CController::GetIpAddress() const
+int CController::GetTickJitterBinLimit(int bin)
 {
-	return m_ipAddress;
+	jassert((bin >= 0) && (bin < TICK_JITTER_BINS));
+	return TICK_JITTER_BIN_LIMITS[bin];
 }
 
 /**
- * Static methiod which returns the default IP address.
- * @return	IP address to use as default.
+ * Number of timer ticks whose actual period deviated from the nominal interval by an amount within the given bin.
+ * @param bin	Histogram bin, 0 to TICK_JITTER_BINS - 1. See GetTickJitterBinLimit().
+ * @return	Number of ticks counted in the bin since the last reset.
  */
-String CController::GetDefaultIpAddress()
+int CController::GetTickJitterCount(int bin) const
 {
-	return OSC_DEFAULT_IP;
+	jassert((bin >= 0) && (bin < TICK_JITTER_BINS));
+	return m_tickJitterHistogram[bin];
 }
 
 /**
- * Setter function for the IP address to which m_oscSender and m_oscReceiver are connected.
- * NOTE: changing ip address will disconnect m_oscSender and m_oscReceiver.
- * @param changeSource	The application module which is causing the property change.
- * @param ipAddress		New IP address.
+ * Clear the tick jitter histogram. This also happens whenever the interval is changed.
  */
-void CController::SetIpAddress(DataChangeSource changeSource, String ipAddress)
+void CController::ResetTickJitterHistogram()
 {
-	if (m_ipAddress != ipAddress)
-	{
-		const ScopedLock lock(m_mutex);
-
-		m_ipAddress = ipAddress;
-
-		// Start "offline" after changing IP address
-		m_heartBeatsRx = MAX_HEARTBEAT_COUNT;
-		m_heartBeatsTx = 0;
-
-		// Signal the change to all plugins. 
-		SetParameterChanged(changeSource, (DCT_IPAddress | DCT_Online));
-
-		ReconnectOsc();
-	}
+	for (int bin = 0; bin < TICK_JITTER_BINS; ++bin)
+		m_tickJitterHistogram[bin] = 0;
+	m_tickJitterMax = 0;
 }
 
 /**
- * Getter function for the OSC communication state.
- * @return		True if a valid OSC message was received and successfully processed recently.
- *				False if no response was received for longer than the timeout threshold.
+ * Lock statistics of one of the CController's synchronisation domains, i.e. for a debug overlay.
+ * @param domain	The lock in question.
+ * @return	Number of acquisitions and contentions, and wait and hold times since the last ResetLockProfiles() call.
  */
-bool CController::GetOnline() const
+CProfiledMutex::Profile CController::GetLockProfile(LockDomain domain) const
 {
-	return ((m_heartBeatsRx * m_oscMsgRate) < KEEPALIVE_TIMEOUT);
+	switch (domain)
+	{
+	case LD_Send:
+		return m_sendMutex.GetProfile();
+	case LD_Registry:
+		return m_registryMutex.GetProfile();
+	default:
+		break;
+	}
+
+	jassertfalse; // Unknown lock domain!
+	return CProfiledMutex::Profile();
 }
 
 /**
- * Getter for the rate at which OSC messages are being sent out.
- * @return	Messaging rate, in milliseconds.
+ * Restart the lock statistics of all synchronisation domains.
  */
-int CController::GetRate() const
+void CController::ResetLockProfiles()
 {
-	return m_oscMsgRate;
+	m_sendMutex.ResetProfile();
+	m_registryMutex.ResetProfile();
 }
 
 /**
- * Setter for the rate at which OSC messages are being sent out.
- * @param changeSource	The application module which is causing the property change.
- * @param rate	New messaging rate, in milliseconds.
+ * Write the lock statistics of all synchronisation domains to the debug log. 
+ * Called along with the tick jitter histogram, see UpdateTickJitter().
  */
-void CController::SetRate(DataChangeSource changeSource, int rate)
+void CController::LogLockProfiles() const
 {
-	if (rate != m_oscMsgRate)
+	static const char* kLockDomainNames[LD_Max] = { "send", "registry" };
+
+	for (int d = 0; d < LD_Max; ++d)
 	{
-		const ScopedLock lock(m_mutex);
+		CProfiledMutex::Profile profile = GetLockProfile(static_cast<LockDomain>(d));
+		String report;
+		report << kLockDomainNames[d] << ": " << profile.acquisitions << " locks, " << profile.contentions << " contended, "
+			<< "wait avg/max " << String(profile.waitTotal / jmax<int64>(1, profile.acquisitions), 1) << "/" << String(profile.waitMax, 1) << "us, "
+			<< "hold avg/max " << String(profile.holdTotal / jmax<int64>(1, profile.acquisitions), 1) << "/" << String(profile.holdMax, 1) << "us";
+		DBG("CController::LogLockProfiles: " + report);
+	}
+}
 
-		// Clip rate to the allowed range.
-		rate = jmin(OSC_INTERVAL_MAX, jmax(OSC_INTERVAL_MIN, rate));
+/**
+ * Number of UDP datagrams to one of the DS100 devices which are currently waiting in the send queue. 
+ * A queue which does not drain between timer ticks indicates that sending can't keep up.
+ * @param deviceId	Index of the device within the device table.
+ * @return	Current send queue depth, in datagrams.
+ */
+int CController::GetTxQueuedPackets(DeviceId deviceId) const
+{
+	if (!IsValidDeviceId(deviceId))
+		return 0;
 
-		m_oscMsgRate = rate;
+	return m_devices[deviceId].GetTxQueuedPackets();
+}
 
-		// Signal the change to all plugins.
-		SetParameterChanged(changeSource, DCT_MessageRate);
+/**
+ * Number of UDP datagrams to one of the DS100 devices which were discarded because the send queue was full.
+ * @param deviceId	Index of the device within the device table.
+ * @return	Total number of dropped datagrams.
+ */
+int CController::GetTxDroppedPackets(DeviceId deviceId) const
+{
+	if (!IsValidDeviceId(deviceId))
+		return 0;
 
-		// Reset timer to the new interval.
-		startTimer(m_oscMsgRate);
-	}
+	return m_devices[deviceId].GetTxDroppedPackets();
 }
 
 /**
- * Static methiod which returns the allowed minimum and maximum OSC message rates.
- * @return	Returns a std::pair<int, int> where the first number is the minimum supported rate, 
- *			and the second number is the maximum.
+ * Number of UDP datagrams to one of the DS100 devices which the send thread failed to write to its socket.
+ * @param deviceId	Index of the device within the device table.
+ * @return	Total number of failed datagrams.
  */
-std::pair<int, int> CController::GetSupportedRateRange()
+int CController::GetTxFailedPackets(DeviceId deviceId) const
 {
-	return std::pair<int, int>(OSC_INTERVAL_MIN, OSC_INTERVAL_MAX);
+	if (!IsValidDeviceId(deviceId))
+		return 0;
+
+	return m_devices[deviceId].GetTxFailedPackets();
 }
 
 /**
@@ -391,200 +1399,399 @@ void CController::InitGlobalSettings(DataChangeSource changeSource, String ipAdd
 }
 
 /**
- * Called when the OSCReceiver receives a new OSC message, since CController inherits from OSCReceiver::Listener.
- * It forwards the message to all registered plugin objects.
+ * Method to initialize the IP addresses of the additional DS100 devices, i.e. all entries of the device table 
+ * except for the first one, which is initialized by InitGlobalSettings(). Entries which are already in use 
+ * are not overwritten, so that the first Plug-in instance of a project to be restored defines the device table.
+ * @param changeSource	The application module which is causing the property change.
+ * @param ipAddresses	IP addresses for the device table, starting with device 0. Empty strings for unused devices.
+ */
+void CController::InitDeviceTable(DataChangeSource changeSource, const StringArray& ipAddresses)
+{
+	for (DeviceId deviceId = 1; deviceId < jmin(DEVICE_COUNT_MAX, ipAddresses.size()); ++deviceId)
+	{
+		if (GetIpAddress(deviceId).isEmpty())
+			SetIpAddress(changeSource, ipAddresses[deviceId], deviceId);
+	}
+}
+
+/**
+ * Called on m_oscReceiveThread whenever a datagram arrives from the network. The datagram is parsed right away,
+ * and the received values are stored in the sending device's CSourceStateTable, without taking any of the CController's locks. 
+ * They are applied to the Plug-ins during the next timer tick, see ApplyReceivedValues().
+ * Datagrams from IP addresses which are not in the device table are counted, see GetUnmatchedDatagramCount(). 
+ * They are assigned to the only device in use if there is exactly one, i.e. if the DS100 replies from 
+ * a different interface than the one it is addressed on, and are ignored otherwise.
+ * @param data				Pointer to the received datagram.
+ * @param size				Size of the received datagram, in bytes.
+ * @param senderAddress	IPv4 address of the device which sent the datagram, in host byte order.
+ */
+void CController::oscDatagramReceived(const char* data, int size, uint32 senderAddress)
+{
+	DeviceId deviceId = FindDevice(senderAddress);
+	if (deviceId < 0)
+	{
+		m_unmatchedDatagrams++;
+		deviceId = GetOnlyUsedDevice();
+	}
+
+	if (deviceId >= 0)
+	{
+		m_rxDevice = &m_devices[deviceId];
+		COscDecoder::DecodePacket(data, size, this);
+		m_rxDevice = nullptr;
+	}
+}
+
+/**
+ * Parse a received OSC message, and store the contained values in the CSourceStateTable of m_rxDevice, which sent it.
+ * Messages which COscAddressParser does not recognize are counted, see GetUnparsedMessageCount(), and ignored.
+ * Called on m_oscReceiveThread, from within oscDatagramReceived().
+ * Reimplemented from COscDecoder::Listener.
  * @param message	The received OSC message.
  */
-void CController::oscMessageReceived(const OSCMessage &message)
+void CController::oscMessageDecoded(const COscMessageView& message)
 {
-	const ScopedLock lock(m_mutex);
-	jassert(m_processors.size() > 0);
+	jassert(m_rxDevice != nullptr);
+	CDevice& device = *m_rxDevice;
+
+	// Identify the message by its address pattern.
+	COscAddressParser::Address address = COscAddressParser::Parse(message.GetAddress());
+
+	bool resetHeartbeat = false;
 
-	if (m_processors.size() > 0)
+	// The DS100 only replies with the address patterns it was sent. Anything else is not meant for us.
+	if (address.response == OscRsp_Unknown)
+		m_unparsedMessages++;
+
+	// Check if the incoming message is a response to a sent "ping".
+	else if (address.response == OscRsp_Pong)
+		resetHeartbeat = true;
+
+	// Check if the incoming message contains parameters.
+	else if ((address.response == OscRsp_Command) && (message.GetNumArguments() > 0))
 	{
-		int i;
-		bool resetHeartbeat = false;
+		CSourceStateTable& table = device.GetReceivedValues();
+		switch (address.command)
+		{
+			case OscCmd_SourcePositionXY:
+				if ((message.GetNumArguments() >= 2) && message.IsFloat32(0) && message.IsFloat32(1))
+					table.Publish(OscCmd_SourcePositionXY, address.sourceId, address.mappingId, message.GetFloat32(0), message.GetFloat32(1));
+				break;
+
+			case OscCmd_SourceDelayMode:
+				// DelayMode is an integer.
+				if (message.IsInt32(0))
+					table.Publish(OscCmd_SourceDelayMode, address.sourceId, 0, static_cast<float>(message.GetInt32(0)), 0.0f);
+				else if (message.IsFloat32(0))
+					table.Publish(OscCmd_SourceDelayMode, address.sourceId, 0, message.GetFloat32(0), 0.0f);
+				break;
+
+			case OscCmd_ReverbSendGain:
+			case OscCmd_SourceSpread:
+				if (message.IsFloat32(0))
+					table.Publish(address.command, address.sourceId, 0, message.GetFloat32(0), 0.0f);
+				break;
+
+			default:
+				jassertfalse;
+				break;
+		}
+
+		// Since the address pattern was recognized, we know the received OSC message has valid format.
+		// -> Signal to reset the number of heartbeats since last response.
+		resetHeartbeat = true;
+	}
+
+	// A valid OSC message was received and successfully processed.
+	if (resetHeartbeat)
+		device.ResponseReceived();
+}
 
-		// Check if the incoming message is a response to a sent "ping".
-		String addressString = message.getAddressPattern().toString();
-		if (addressString.startsWith(kOscResponseString_pong))
-			resetHeartbeat = true;
+/**
+ * Apply all values which were received since the last call to the Plug-ins which are bound to the 
+ * respective device and SourceId. Only the latest value of each parameter is applied, so a burst of replies 
+ * results in a single SetParameterValue() call, and host notification, per parameter.
+ * Called on the message thread, where Plug-ins are destroyed, so they stay valid while their values are applied.
+ * The values are collected while holding m_registryMutex, and applied after releasing it, so that the 
+ * host is notified (setValueNotifyingHost(), beginChangeGesture()) without any of the CController's locks held.
+ */
+void CController::ApplyReceivedValues()
+{
+	m_receivedValues.clearQuick();
+
+	{ // Scope for lock. The routing table may be changed by other threads meanwhile, see UpdateSourceRoute().
+		const CProfiledMutex::ScopedLockType lock(m_registryMutex);
 
-		// Check if the incoming message contains parameters.
-		else if (message.size() > 0)
+		for (DeviceId deviceId = 0; deviceId < DEVICE_COUNT_MAX; ++deviceId)
 		{
-			// Parse the Source ID
-			SourceId sourceId = (addressString.fromLastOccurrenceOf(kOscDelimiterString, false, true)).getIntValue();
-			jassert(sourceId > 0);
-			if (sourceId > 0)
+			CSourceStateTable& table = m_devices[deviceId].GetReceivedValues();
+
+			for (int cmd = 0; cmd < OscCmd_MaxIndex; ++cmd)
 			{
-				AutomationParameterIndex pIdx = ParamIdx_MaxIndex;
-				DataChangeTypes change = DCT_None;
-				int mappingId = 0;
+				OscCommand command = static_cast<OscCommand>(cmd);
 
-				// Determine which parameter was changed depending on the incoming message's address pattern.
-				if (addressString.startsWith(kOscResponseString_source_position_xy))
+				// X/Y coordinates are received separately for each coordinate mapping.
+				int mappingIdMax = (command == OscCmd_SourcePositionXY) ? MAPPING_ID_MAX : MAPPING_ID_MIN;
+				for (int mappingId = MAPPING_ID_MIN; mappingId <= mappingIdMax; ++mappingId)
 				{
-					// Parse the Mapping ID
-					addressString = addressString.upToLastOccurrenceOf(kOscDelimiterString, false, true);
-					mappingId = (addressString.fromLastOccurrenceOf(kOscDelimiterString, false, true)).getIntValue();
-					jassert(mappingId > 0);
+					uint64 pending = table.TakePending(command, mappingId);
+					for (int bit = 0; pending != 0; ++bit, pending >>= 1)
+					{
+						if ((pending & 1) == 0)
+							continue;
 
-					pIdx = ParamIdx_X;
-					change = DCT_SourcePosition;
-				}
-				else if (addressString.startsWith(kOscResponseString_reverbsendgain))
-				{
-					pIdx = ParamIdx_ReverbSendGain;
-					change = DCT_ReverbSendGain;
-				}
-				else if (addressString.startsWith(kOscResponseString_source_spread))
-				{
-					pIdx = ParamIdx_SourceSpread;
-					change = DCT_SourceSpread;
-				}
-				else if (addressString.startsWith(kOscResponseString_source_delaymode))
-				{
-					pIdx = ParamIdx_DelayMode;
-					change = DCT_DelayMode;
-				}
+						SourceId sourceId = SOURCE_ID_MIN + bit;
+						ReceivedValue received;
+						received.command = command;
+						table.Read(command, sourceId, mappingId, received.value1, received.value2);
 
-				// Continue if the message's address pattern was recognized 
-				if (change != DCT_None)
-				{
-					// Check all plugin instances to see if any of them want the new coordinates.
-					for (i = 0; i < m_processors.size(); ++i)
-					{
-						// Check for matching Input number.
-						CPlugin* plugin = m_processors[i];
-						if (sourceId == plugin->GetSourceId())
+						// Pass the new values on to the plugin instances bound to this device and Input number.
+						const Array<CPlugin*>& route = GetSourceRoute(deviceId, sourceId);
+						for (int i = 0; i < route.size(); ++i)
 						{
-							// Check if a SET command was recently sent out and might currently be on transit to the device.
-							// If so, ignore the incoming message so that our local data does not jump back to a now outdated value.
-							bool ignoreResponse = plugin->IsParamInTransit(change);
-							ComsMode mode = plugin->GetComsMode();
-
-							// Only pass on new positions to plugins that are in RX mode.
-							// Also, ignore all incoming messages for properties which this plugin wants to send a set command.
-							if (!ignoreResponse && ((mode & (CM_Rx | CM_PollOnce)) != 0) && (plugin->GetParameterChanged(DCS_Osc, change) == false))
-							{
-								// Special handling for X/Y position, since message contains two parameters and MappingID needs to match too.
-								if (pIdx == ParamIdx_X)
-								{
-									if (mappingId == plugin->GetMappingId())
-									{
-										// Set the plugin's new position.
-										plugin->SetParameterValue(DCS_Osc, ParamIdx_X, message[0].getFloat32());
-										plugin->SetParameterValue(DCS_Osc, ParamIdx_Y, message[1].getFloat32());
-
-										// A request was sent to the DS100 by the CController because this plugin was in CM_PollOnce mode.
-										// Since the response was now processed, set the plugin back into it's original mode.
-										if ((mode & CM_PollOnce) == CM_PollOnce)
-										{
-											mode &= ~CM_PollOnce;
-											plugin->SetComsMode(DCS_Osc, mode);
-										}
-									}
-								}
-
-								// All other automation parameters.
-								else 
-								{
-									// DelayMode is an integer.
-									float newValue;
-									if ((pIdx == ParamIdx_DelayMode) && message[0].isInt32())
-										newValue = static_cast<float>(message[0].getInt32());
-									else
-										newValue = message[0].getFloat32();
-
-									plugin->SetParameterValue(DCS_Osc, pIdx, newValue);
-								}
-							}
+							// X/Y position is only relevant if the MappingID matches too.
+							received.plugin = route.getUnchecked(i);
+							if ((command != OscCmd_SourcePositionXY) || (mappingId == received.plugin->GetMappingId()))
+								m_receivedValues.add(received);
 						}
 					}
-
-					// Since pIdx was set, we know the received OSC message has valid format.
-					// -> Signal to reset the number of heartbeats since last response.
-					resetHeartbeat = true;
 				}
 			}
 		}
+	}
+
+	for (const ReceivedValue& received : m_receivedValues)
+		ApplyReceivedValue(received.plugin, received.command, received.value1, received.value2);
+
+	m_receivedValuesApplied = true;
+}
+
+/**
+ * Apply a received value to a Plug-in, unless the Plug-in ignores it because of its Rx/Tx mode or local changes.
+ * Called on the message thread, see ApplyReceivedValues().
+ * @param plugin	The Plug-in bound to the device and SourceId of the received value.
+ * @param command	The OscCommand to which the value belongs.
+ * @param value1	Received value, or X coordinate.
+ * @param value2	Y coordinate, only relevant for OscCmd_SourcePositionXY.
+ */
+void CController::ApplyReceivedValue(CPlugin* plugin, OscCommand command, float value1, float value2)
+{
+	AutomationParameterIndex pIdx = kOscCommandParamIndices[command];
+	DataChangeTypes change = kOscCommandChangeTypes[command];
+
+	// Check if a SET command was recently sent out and might currently be on transit to the device.
+	// If so, ignore the incoming message so that our local data does not jump back to a now outdated value.
+	bool ignoreResponse = plugin->IsParamInTransit(change);
+	ComsMode mode = plugin->GetComsMode();
+
+	// Only pass on new positions to plugins that are in RX mode.
+	// Also, ignore all incoming messages for properties which this plugin wants to send a set command.
+	if (!ignoreResponse && ((mode & (CM_Rx | CM_PollOnce)) != 0) && (plugin->GetParameterChanged(DCS_Osc, change) == false))
+	{
+		// Special handling for X/Y position, since message contains two parameters.
+		if (pIdx == ParamIdx_X)
+		{
+			// Set the plugin's new position.
+			float oldX = plugin->GetParameterValue(ParamIdx_X);
+			float oldY = plugin->GetParameterValue(ParamIdx_Y);
+			plugin->SetParameterValue(DCS_Osc, ParamIdx_X, value1);
+			plugin->SetParameterValue(DCS_Osc, ParamIdx_Y, value2);
+
+			// Adapt the poll interval to whether the source is currently moving.
+			bool moved = ((oldX != plugin->GetParameterValue(ParamIdx_X)) || (oldY != plugin->GetParameterValue(ParamIdx_Y)));
+			plugin->SetPollActivity(command, moved);
+
+			// A request was sent to the DS100 by the CController because this plugin was in CM_PollOnce mode.
+			// Since the response was now processed, set the plugin back into it's original mode.
+			if ((mode & CM_PollOnce) == CM_PollOnce)
+				plugin->ClearPollOnce(DCS_Osc);
+		}
 
-		// A valid OSC message was received and successfully processed
-		// -> reset the number of heartbeats since last response.
-		if (resetHeartbeat)
+		// All other automation parameters.
+		else 
 		{
-			bool wasOnline = GetOnline();
-			m_heartBeatsRx = 0;
+			float oldValue = plugin->GetParameterValue(pIdx);
+			plugin->SetParameterValue(DCS_Osc, pIdx, value1);
+
+			// Adapt the poll interval to whether the parameter is currently changing.
+			plugin->SetPollActivity(command, (oldValue != plugin->GetParameterValue(pIdx)));
+		}
+	}
+}
+
+/**
+ * Callback from m_setDeadline, on the deadline timer's own thread. Sends out the SET commands of all Plug-ins
+ * which were queued by QueueProcessorForSet() since the last deadline. Plug-ins which have sent SET commands 
+ * less than SET_INTERVAL_MIN ago are kept on the list, and the deadline is re-armed for when they may send again.
+ */
+void CController::SendQueuedSetCommands()
+{
+	const CProfiledMutex::ScopedLockType lock(m_sendMutex);
+
+	const uint32 now = Time::getMillisecondCounter();
+	int retryDelay = 0;
+
+	CPlugin* pro = m_queuedProcessors[PQ_Set].exchange(nullptr, std::memory_order_acquire);
+	while (pro != nullptr)
+	{
+		CPlugin* nextPro = pro->GetNextQueued(PQ_Set);
+		pro->ClearQueued(PQ_Set);
 
-			// If previous state was "Offline", force all plugins to
-			// update their GUI, since we are now Online.
-			if (!wasOnline)
+		if (!pro->GetBypass())
+		{
+			int holdOff = SET_INTERVAL_MIN - static_cast<int>(now - pro->GetLastSetTime());
+			if (holdOff > 0)
+			{
+				// Rate cap for this source: try again later, with whatever the latest values are by then.
+				if (pro->MarkQueued(PQ_Set))
+					PushQueuedProcessor(PQ_Set, pro);
+				retryDelay = (retryDelay > 0) ? jmin(retryDelay, holdOff) : holdOff;
+			}
+			else
 			{
-				SetParameterChanged(DCS_Osc, DCT_Online);
+				DataChangeTypes paramSetsSent = m_devices[pro->GetDeviceId()].SendSetCommands(pro);
+				if (paramSetsSent != DCT_None)
+				{
+					pro->SetLastSetTime(now);
+					pro->SetParamInTransit(paramSetsSent);
+
+					// The in-transit flags are cleared during a timer tick.
+					QueueProcessorForTick(pro);
+				}
 			}
 		}
+
+		pro = nextPro;
 	}
+
+	for (DeviceId deviceId = 0; deviceId < DEVICE_COUNT_MAX; ++deviceId)
+		m_devices[deviceId].Flush();
+
+	if (retryDelay > 0)
+		m_setDeadline.Arm(retryDelay);
 }
 
 /**
- * Send a OSCMessage out to the connected ip address.
- * @param message	The OSC message to be sent.
+ * Count the deviation of the actual period of the current timer tick from the nominal interval
+ * in the tick jitter histogram. In debug builds, the histogram is logged every TICK_JITTER_REPORT ms.
+ * Must be called at the very start of each tick, before hiResTimerCallback() updates m_lastTickTime.
  */
-bool CController::SendOSCMessage(OSCMessage message)
+void CController::UpdateTickJitter()
 {
-	bool ret = (m_oscSender.send(message));
-	if (ret)
-		m_heartBeatsTx = 0;
-	return ret;
+	if (m_lastTickTime > 0.0)
+	{
+		double period = Time::getMillisecondCounterHiRes() - m_lastTickTime;
+		int jitter = roundToInt(std::abs(period - m_oscMsgRate) * 1000.0);
+
+		int bin = 0;
+		while ((bin < (TICK_JITTER_BINS - 1)) && (jitter > TICK_JITTER_BIN_LIMITS[bin]))
+			bin++;
+		m_tickJitterHistogram[bin]++;
+		if (jitter > m_tickJitterMax)
+			m_tickJitterMax = jitter;
+
+#ifdef JUCE_DEBUG
+		int numTicks = 0;
+		for (int i = 0; i < TICK_JITTER_BINS; ++i)
+			numTicks += m_tickJitterHistogram[i];
+		if ((numTicks % jmax(1, TICK_JITTER_REPORT / m_oscMsgRate)) == 0)
+		{
+			String histogram;
+			for (int i = 0; i < TICK_JITTER_BINS - 1; ++i)
+				histogram << "<=" << TICK_JITTER_BIN_LIMITS[i] << "us: " << m_tickJitterHistogram[i] << ", ";
+			histogram << "more: " << m_tickJitterHistogram[TICK_JITTER_BINS - 1] << ", max: " << m_tickJitterMax << "us";
+			DBG("CController::UpdateTickJitter: " + histogram);
+			DBG("CController::UpdateTickJitter: unmatched datagrams: " + String(m_unmatchedDatagrams.load()) + 
+				", unparsed messages: " + String(m_unparsedMessages.load()));
+			LogLockProfiles();
+		}
+#endif
+	}
 }
 
 /**
- * Disconnect the OSCSender from it's host.
+ * Stop the sending threads of all devices, and the receiving thread.
  */
 void CController::DisconnectOsc()
 {
-	m_oscSender.disconnect();
-	m_oscReceiver.disconnect();
+	const CProfiledMutex::ScopedLockType lock(m_sendMutex);
+
+	for (DeviceId deviceId = 0; deviceId < DEVICE_COUNT_MAX; ++deviceId)
+		m_devices[deviceId].Disconnect();
+
+	m_oscReceiveThread.Stop();
 }
 
 /**
- * Disconnect and re-connect the OSCSender to a host specified by the current ip settings.
+ * Re-open the sending sockets of all devices in use, and the receiving socket, after the ip settings have changed.
  */
 void CController::ReconnectOsc()
 {
-	DisconnectOsc();
+	const CProfiledMutex::ScopedLockType lock(m_sendMutex);
 
-	// Connect both sender and receiver  
-	bool ok = m_oscSender.connect(m_ipAddress, RX_PORT_DS100);
-	jassert(ok);
+	// Same as DisconnectOsc(), which can't be called here since m_sendMutex is not re-entrant.
+	for (DeviceId deviceId = 0; deviceId < DEVICE_COUNT_MAX; ++deviceId)
+		m_devices[deviceId].Disconnect();
+	m_oscReceiveThread.Stop();
+
+	// Each device's sending thread opens its socket on any free local port.
+	for (DeviceId deviceId = 0; deviceId < DEVICE_COUNT_MAX; ++deviceId)
+		m_devices[deviceId].Connect();
 
-	ok = m_oscReceiver.connect(RX_PORT_HOST);
+	bool ok = m_oscReceiveThread.Start(RX_PORT_HOST);
 	jassert(ok);
+	ignoreUnused(ok);
 }
 
 /**
  * Timer callback function, which will be called at regular intervals to
- * send out OSC messages.
- * Reimplemented from base class Timer.
+ * send out OSC messages. Runs on the HighResolutionTimer's own thread, so that
+ * the interval is not affected by the message thread being busy, i.e. with painting.
+ * Parameter changes and gestures caused by received values are not passed to the host from here,
+ * but from the message thread, see handleAsyncUpdate().
+ * Reimplemented from base class HighResolutionTimer.
  */
-void CController::timerCallback()
+void CController::hiResTimerCallback()
 {
-	const ScopedLock lock(m_mutex);
-	if (m_processors.size() > 0)
+	const CProfiledMutex::ScopedLockType lock(m_sendMutex);
+
+	UpdateTickJitter();
+
+	if (GetProcessorCount() > 0)
 	{
-		// Check that we don't flood the line with pings, only send them in small intervals.
-		bool sendKeepAlive = (((m_heartBeatsRx * m_oscMsgRate) > KEEPALIVE_INTERVAL) ||
-								((m_heartBeatsTx * m_oscMsgRate) > KEEPALIVE_INTERVAL));
+		// Top up the request budgets for the time which has passed since the last tick.
+		double now = Time::getMillisecondCounterHiRes();
+		double elapsed = (m_lastTickTime > 0.0) ? (now - m_lastTickTime) : static_cast<double>(m_oscMsgRate);
+		m_lastTickTime = now;
+		for (DeviceId deviceId = 0; deviceId < DEVICE_COUNT_MAX; ++deviceId)
+			m_devices[deviceId].BeginTick(elapsed, m_oscMsgRate);
+
+		// Have the message thread hand the values received since the last pass over to the Plug-ins. At fast rates, 
+		// this is only done about once per RX_APPLY_INTERVAL_MIN, so that a burst of replies for the same parameter 
+		// is applied, and notified to the host, only once. Half a tick of tolerance keeps slower rates from skipping ticks due to jitter.
+		if ((now - m_lastApplyTime) >= (RX_APPLY_INTERVAL_MIN - (0.5 * m_oscMsgRate)))
+		{
+			triggerAsyncUpdate();
+			m_lastApplyTime = now;
+		}
+		bool receivedValuesApplied = m_receivedValuesApplied.exchange(false);
 
-		int i;
-		CPlugin* pro = nullptr;
+		// Only visit the Plug-ins which were queued since the last tick, see QueueProcessorForTick().
+		// The whole list is taken at once, so Plug-ins queued while we iterate end up on a fresh list for the next tick.
+		CPlugin* pro = m_queuedProcessors[PQ_Tick].exchange(nullptr, std::memory_order_acquire);
 		ComsMode mode;
-		String messageString;
 
-		for (i = 0; i < m_processors.size(); ++i)
+		while (pro != nullptr)
 		{
-			pro = m_processors[i];
+			CPlugin* nextPro = pro->GetNextQueued(PQ_Tick);
+			pro->ClearQueued(PQ_Tick);
+
+			// Wake the GUIs for changes made by the host, which are not notified from its audio thread.
+			// See CPlugin::SetParameterChanged(). This must come after ClearQueued(), so that changes
+			// published in the meantime either show up here or queue the Plug-in again.
+			DataChangeTypes hostChanges = pro->PopPendingNotifications();
+			if (hostChanges != DCT_None)
+				NotifyChangeSubscribers(pro, hostChanges);
 
 			// If the OscBypass parameter has changed since the last interval, 
 			// update the OSC Rx/Tx mode of each Plugin accordingly.
@@ -602,159 +1809,63 @@ void CController::timerCallback()
 			}
 			mode = pro->GetComsMode();
 
-			// Signal every timer tick to each plugin instance. 
-			// This is used to trigger gestures for touch automation.
-			pro->Tick();
+			// Replies to SET commands sent before the last tick have been applied or discarded, 
+			// so they can't overwrite newer local values anymore.
+			if (receivedValuesApplied)
+				pro->ClearParamInTransit();
 
 			// If plugin is in Bypass, we can skip all of the stuff below.
+			DataChangeTypes paramSetsInTransit = DCT_None;
 			if (!oscBypassed)
 			{
-				bool msgSent;
-				DataChangeTypes paramSetsInTransit = DCT_None;
-
-				// Iterate through all automation parameters.
-				for (int pIdx = ParamIdx_X; pIdx < ParamIdx_MaxIndex; ++pIdx)
-				{
-					msgSent = false;
-
-					switch (pIdx)
-					{
-						case ParamIdx_X:
-						{
-							// SET command is only sent out while in CM_Tx mode, provided that
-							// this parameter has been changed since the last timer tick.
-							if (((mode & CM_Tx) == CM_Tx) && pro->GetParameterChanged(DCS_Osc, DCT_SourcePosition))
-							{
-								messageString = String::formatted(kOscCommandString_source_position_xy, pro->GetMappingId(), pro->GetSourceId());
-								msgSent = SendOSCMessage(OSCMessage(messageString, pro->GetParameterValue(ParamIdx_X), pro->GetParameterValue(ParamIdx_Y)));
-								paramSetsInTransit |= DCT_SourcePosition;
-							}
-
-							// GET command for x/y coordinates is only sent out while in CM_Rx or CM_PollOnce mode,
-							// provided that we didn't already send a SET command. Get command is just the OSC address pattern without parameters.
-							if ((!msgSent) && ((mode & (CM_Rx | CM_PollOnce)) != 0))
-							{
-								messageString = String::formatted(kOscCommandString_source_position_xy, pro->GetMappingId(), pro->GetSourceId());
-								msgSent = SendOSCMessage(OSCMessage(messageString));
-							}
-						}
-						break;
-
-						case ParamIdx_Y:
-							// Changes to ParamIdx_Y are handled together with ParamIdx_X, so skip it.
-							continue;
-							break;
-
-						case ParamIdx_ReverbSendGain:
-						{
-							// SET command is only sent out while in CM_Tx mode, provided that
-							// this parameter has been changed since the last timer tick.
-							if (((mode & CM_Tx) == CM_Tx) && pro->GetParameterChanged(DCS_Osc, DCT_ReverbSendGain))
-							{
-								messageString = String::formatted(kOscCommandString_reverbsendgain, pro->GetSourceId());
-								msgSent = SendOSCMessage(OSCMessage(messageString, pro->GetParameterValue(ParamIdx_ReverbSendGain)));
-								paramSetsInTransit |= DCT_ReverbSendGain;
-							}
-
-							// GET command is only sent out while in CM_Rx mode, provided that we 
-							// didn't already send a SET command. Get command is just the OSC address pattern without parameters.
-							if ((!msgSent) && ((mode & CM_Rx) == CM_Rx))
-							{
-								messageString = String::formatted(kOscCommandString_reverbsendgain, pro->GetSourceId());
-								msgSent = SendOSCMessage(OSCMessage(messageString));
-							}
-						}
-						break;
+				CDevice& device = m_devices[pro->GetDeviceId()];
 
-						case ParamIdx_SourceSpread:
-						{
-							// SET command is only sent out while in CM_Tx mode, provided that
-							// this parameter has been changed since the last timer tick.
-							if (((mode & CM_Tx) == CM_Tx) && pro->GetParameterChanged(DCS_Osc, DCT_SourceSpread))
-							{
-								messageString = String::formatted(kOscCommandString_source_spread, pro->GetSourceId());
-								msgSent = SendOSCMessage(OSCMessage(messageString, pro->GetParameterValue(ParamIdx_SourceSpread)));
-								paramSetsInTransit |= DCT_SourceSpread;
-							}
-
-							// GET command is only sent out while in CM_Rx mode, provided that we 
-							// didn't already send a SET command. Get command is just the OSC address pattern without parameters.
-							if ((!msgSent) && ((mode & CM_Rx) == CM_Rx))
-							{
-								messageString = String::formatted(kOscCommandString_source_spread, pro->GetSourceId());
-								msgSent = SendOSCMessage(OSCMessage(messageString));
-							}
-						}
-						break;
-
-						case ParamIdx_DelayMode:
-						{
-							// SET command is only sent out while in CM_Tx mode, provided that
-							// this parameter has been changed since the last timer tick.
-							if (((mode & CM_Tx) == CM_Tx) && pro->GetParameterChanged(DCS_Osc, DCT_DelayMode))
-							{
-								messageString = String::formatted(kOscCommandString_source_delaymode, pro->GetSourceId());
-								msgSent = SendOSCMessage(OSCMessage(messageString, static_cast<int>(pro->GetParameterValue(ParamIdx_DelayMode))));
-								paramSetsInTransit |= DCT_DelayMode;
-							}
-
-							// GET command is only sent out while in CM_Rx mode, provided that we 
-							// didn't already send a SET command. Get command is just the OSC address pattern without parameters.
-							if ((!msgSent) && ((mode & CM_Rx) == CM_Rx))
-							{
-								messageString = String::formatted(kOscCommandString_source_delaymode, pro->GetSourceId());
-								msgSent = SendOSCMessage(OSCMessage(messageString));
-							}
-						}
-						break;
+				// SET commands for all parameters which have been changed since the last timer tick.
+				paramSetsInTransit = device.SendSetCommands(pro);
 
-						case ParamIdx_Bypass:
-							// Nothing to do, this is not a parameter which will arrive per OSC.
-							continue;
-							break;
+				// Flag the parameters for which we just sent a SET command out. The flags are kept 
+				// until the next time received values are applied.
+				pro->SetParamInTransit(paramSetsInTransit);
 
-						default:
-							jassertfalse;
-							break;
-					}
+				// GET commands are sent out at the end of the tick, within the device's request budget.
+				if ((mode & (CM_Rx | CM_PollOnce)) != 0)
+					device.AddPollingProcessor(pro);
+			}
 
-					if (msgSent)
-					{
-						// Since we are expecting at least one response from the DS100, 
-						// we can use that as heartbeat, no need to send an extra ping.
-						sendKeepAlive = false;
-					}
-				}
+			// SendSetCommands() has reset the flags of the parameters it sent, and changes made since then stay 
+			// flagged for the next tick. Changes which are not sent out at all are dropped.
+			if (oscBypassed || ((mode & CM_Tx) != CM_Tx))
+				pro->PopParameterChanged(DCS_Osc, DCT_AutomationParameters);
 
-				// Flag the parameters for which we just sent a SET command out.
-				pro->SetParamInTransit(paramSetsInTransit);
-			}
+			// Plug-ins which poll the DS100 or wait for responses to SET commands need to be visited again during the next tick.
+			if ((!oscBypassed && ((mode & (CM_Rx | CM_PollOnce)) != 0)) ||
+				pro->IsParamInTransit(DCT_AutomationParameters))
+				QueueProcessorForTick(pro);
 
-			// All changed parameters were sent out, so we can reset their flags now.
-			pro->PopParameterChanged(DCS_Osc, DCT_AutomationParameters);
-		}
-		
-		if (sendKeepAlive)
-		{
-			// If we aren't expecting any responses from the DS100, we need to at least send a "ping"
-			// so that we can use the "pong" to check our connection status. 
-			// See handling of "pong" in oscMessageReceived()
-			OSCMessage oscMessage(kOscCommandString_ping);
-			SendOSCMessage(oscMessage);
+			pro = nextPro;
 		}
 
-		bool wasOnline = GetOnline();
-		if (m_heartBeatsRx < MAX_HEARTBEAT_COUNT)
-			m_heartBeatsRx++;
-		if (m_heartBeatsTx < MAX_HEARTBEAT_COUNT)
-			m_heartBeatsTx++;
+		// Send out GET commands, pings, and whatever else is left of this tick's messages, for each device.
+		DataChangeTypes deviceChanges = DCT_None;
+		for (DeviceId deviceId = 0; deviceId < DEVICE_COUNT_MAX; ++deviceId)
+			deviceChanges |= m_devices[deviceId].EndTick(m_oscMsgRate);
 
-		// If we have just crossed the treshold, force all plugins to update their
-		// GUI, since we are now Offline.
-		if (wasOnline && (GetOnline() == false))
-			SetParameterChanged(DCS_Osc, DCT_Online);
+		// If a device has just gone Online or Offline, or its refresh interval changed, force all plugins to update their GUI.
+		if (deviceChanges != DCT_None)
+			SetParameterChanged(DCS_Osc, deviceChanges);
 	}
 }
 
+/**
+ * Called on the message thread after a timer tick has found that received values are due, see hiResTimerCallback().
+ * Applies them to the Plug-ins, and ends the gestures of automation parameters which have stopped changing.
+ * Only parameters in the middle of a gesture are visited, see CGestureManager.
+ * Reimplemented from base class AsyncUpdater.
+ */
+void CController::handleAsyncUpdate()
+{
+	ApplyReceivedValues();
+	CGestureManager::GetInstance().Advance(Time::getMillisecondCounter());
+}
 
 } // namespace dbaudio
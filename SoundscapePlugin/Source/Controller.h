@@ -36,7 +36,10 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
 #include "Common.h"
-#include <juce_osc/juce_osc.h>				//<USE OSCSender, OSCReceiver
+#include "Device.h"
+#include "OscTransport.h"
+#include <atomic>
+#include <mutex>
 
 
 namespace dbaudio
@@ -49,48 +52,274 @@ namespace dbaudio
 class CPlugin;
 
 
+/**
+ * Abstract class AChangeSubscriber, for GUI components which need to be updated when data changes. 
+ * Subscribers register interest in a mask of DataChangeTypes, either of one Plug-in instance or of all of them, 
+ * and are woken on the message thread only when a matching change occurs. Several changes happening before 
+ * the message thread gets to it are coalesced into one ChangesPending() call. The subscriber then uses the 
+ * usual change flags (see CPlugin::PopParameterChanged()) to find out what exactly has changed.
+ */
+class AChangeSubscriber : private AsyncUpdater
+{
+public:
+	AChangeSubscriber();
+	~AChangeSubscriber() override;
+
+	void Subscribe(DataChangeTypes interest, const CPlugin* plugin);
+	void Unsubscribe();
+	void Notify(const CPlugin* plugin, DataChangeTypes changeTypes);
+
+protected:
+	/**
+	 * Called on the message thread after matching changes have occurred.
+	 */
+	virtual void ChangesPending() = 0;
+
+private:
+	void handleAsyncUpdate() override;
+
+	/**
+	 * Mask of the changes which wake this subscriber.
+	 */
+	std::atomic<DataChangeTypes>	m_interest;
+
+	/**
+	 * Plug-in whose changes wake this subscriber, or nullptr for changes of all Plug-ins.
+	 * Changes of the CController's global settings wake it in any case.
+	 */
+	std::atomic<const CPlugin*>		m_plugin;
+
+	/**
+	 * True while registered with the CController. Only accessed on the message thread.
+	 */
+	bool							m_subscribed;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AChangeSubscriber)
+};
+
+
+/**
+ * Class CProfiledMutex, a non-reentrant mutex which keeps statistics on how long it is waited for and held,
+ * so that lock contention between the CController's threads can be monitored. See CController::GetLockProfile().
+ * Use with CProfiledMutex::ScopedLockType.
+ */
+class CProfiledMutex
+{
+public:
+	typedef GenericScopedLock<CProfiledMutex> ScopedLockType;
+
+	/**
+	 * Lock statistics since the last ResetProfile() call. Times are in microseconds.
+	 */
+	struct Profile
+	{
+		int64	acquisitions = 0;	//< Number of times the lock was taken.
+		int64	contentions = 0;	//< Number of times the lock was already held, and had to be waited for.
+		double	waitTotal = 0.0;	//< Total time spent waiting for the lock.
+		double	waitMax = 0.0;		//< Longest single wait.
+		double	holdTotal = 0.0;	//< Total time the lock was held.
+		double	holdMax = 0.0;		//< Longest single hold.
+	};
+
+	CProfiledMutex();
+	~CProfiledMutex();
+
+	void enter() const;
+	void exit() const;
+
+	Profile GetProfile() const;
+	void ResetProfile();
+
+private:
+	mutable std::mutex	m_mutex;
+
+	/**
+	 * Time at which the current holder took the lock, in high resolution ticks. Only accessed by the holder.
+	 */
+	mutable int64		m_enterTicks;
+
+	/**
+	 * Statistics in high resolution ticks, see Profile. Only updated by the holder, 
+	 * but atomic so that GetProfile() can read them at any time.
+	 */
+	mutable std::atomic<int64>	m_acquisitions;
+	mutable std::atomic<int64>	m_contentions;
+	mutable std::atomic<int64>	m_waitTicks;
+	mutable std::atomic<int64>	m_waitTicksMax;
+	mutable std::atomic<int64>	m_holdTicks;
+	mutable std::atomic<int64>	m_holdTicksMax;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CProfiledMutex)
+};
+
+
+/**
+ * Class CProcessorSnapshot, an immutable copy of the list of registered Plug-in instances.
+ * The CController publishes a new snapshot whenever a Plug-in is added or removed, so that GUI code can
+ * iterate over a consistent list without taking any lock, see CController::GetProcessorSnapshot().
+ * The Plug-in pointers are only guaranteed to be valid on the message thread, where Plug-ins are destroyed.
+ */
+class CProcessorSnapshot : public ReferenceCountedObject
+{
+public:
+	typedef ReferenceCountedObjectPtr<CProcessorSnapshot> Ptr;
+
+	CProcessorSnapshot(const Array<CPlugin*>& processors, const Array<PluginId>& processorIds);
+	~CProcessorSnapshot() override;
+
+	int GetProcessorCount() const;
+	CPlugin* GetProcessor(int idx) const;
+	PluginId GetProcessorId(int idx) const;
+	CPlugin* GetProcessorById(PluginId pluginId) const;
+
+private:
+	/**
+	 * Copies of CController::m_processors and CController::m_processorIds.
+	 */
+	const Array<CPlugin*>	m_processors;
+	const Array<PluginId>	m_processorIds;
+
+	/**
+	 * Index within m_processors of each slot of the CController's slot map, or -1 for unused slots.
+	 */
+	Array<int>				m_indexBySlot;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CProcessorSnapshot)
+};
+
+
 /**
  * Class CController which takes care of OSC communication, including connection establishment
  * and sending/receiving of OSC messages over the network.
+ * Several DS100 devices can be controlled at once, see CDevice. Each Plug-in instance is bound to 
+ * one of them, and its SourceId refers to a matrix input of that device.
  * NOTE: This is a singleton class, i.e. there is only one instance.
  */
 class CController :
-	public OSCReceiver::Listener<OSCReceiver::MessageLoopCallback>,
-	private Timer
+	private COscReceiveThread::Listener,
+	private COscDecoder::Listener,
+	private HighResolutionTimer,
+	private AsyncUpdater
 {
 public:
+	/**
+	 * Number of bins of the tick jitter histogram, see GetTickJitterCount().
+	 */
+	static constexpr int TICK_JITTER_BINS = 8;
+
+	/**
+	 * Number of entries in the device table, i.e. maximum number of DS100 devices controlled at once.
+	 */
+	static constexpr int DEVICE_COUNT_MAX = 4;
+
+	/**
+	 * The CController's synchronisation domains, see GetLockProfile(). Where both are needed, 
+	 * LD_Send is always taken before LD_Registry. Received OSC messages do not take either, 
+	 * see oscDatagramReceived().
+	 */
+	enum LockDomain
+	{
+		LD_Send = 0,	//< Timer tick, low-latency SET commands, and the device table.
+		LD_Registry,	//< Registered Plug-ins, the PluginId slot map, the SourceId routing table, and the devices' IP addresses.
+		LD_Max
+	};
+
+	/**
+	 * Number of global settings whose changes are published through generation counters, see DCT_GlobalSettings.
+	 */
+	static constexpr int GLOBAL_SETTING_COUNT = 5;
+
+	/**
+	 * Generation of each global setting which a consumer, i.e. a Plug-in editor, has last seen.
+	 * All settings start out as unseen. See PopGlobalChanges().
+	 */
+	struct GlobalGenerations
+	{
+		uint32 generation[GLOBAL_SETTING_COUNT] = {};
+	};
+
 	CController();
 	~CController() override;
 	static CController* GetInstance();
+	static CController* GetInstanceWithoutCreating();
 
 	bool GetParameterChanged(DataChangeSource changeSource, DataChangeTypes change);
 	bool PopParameterChanged(DataChangeSource changeSource, DataChangeTypes change);
 	void SetParameterChanged(DataChangeSource changeSource, DataChangeTypes changeTypes);
+	DataChangeTypes PopGlobalChanges(GlobalGenerations& lastSeen) const;
+	void AddChangeSubscriber(AChangeSubscriber* subscriber);
+	void RemoveChangeSubscriber(AChangeSubscriber* subscriber);
+	void NotifyChangeSubscribers(const CPlugin* plugin, DataChangeTypes changeTypes);
 
 	PluginId AddProcessor(CPlugin* p);
 	void RemoveProcessor(CPlugin* p);
 	int GetProcessorCount() const;
-	CPlugin* GetProcessor(PluginId idx) const;
-
-	String GetIpAddress() const;
+	CPlugin* GetProcessor(int idx) const;
+	PluginId GetProcessorId(int idx) const;
+	CPlugin* GetProcessorById(PluginId pluginId) const;
+	CProcessorSnapshot::Ptr GetProcessorSnapshot() const;
+	void QueueProcessorForTick(CPlugin* p);
+	void QueueProcessorForSet(CPlugin* p);
+	void UpdateSourceRoute(CPlugin* p, DeviceId oldDeviceId, SourceId oldSourceId);
+	bool IsSourceIdShared(DeviceId deviceId, SourceId sourceId) const;
+
+	String GetIpAddress(DeviceId deviceId = 0) const;
 	static String GetDefaultIpAddress();
-	void SetIpAddress(DataChangeSource changeSource, String ipAddress);
+	void SetIpAddress(DataChangeSource changeSource, String ipAddress, DeviceId deviceId = 0);
+	DeviceId FindDevice(uint32 senderAddress) const;
+	int GetUnmatchedDatagramCount() const;
+	int GetUnparsedMessageCount() const;
 
 	int GetRate() const;
 	void SetRate(DataChangeSource changeSource, int rate);
 	static std::pair<int, int> GetSupportedRateRange();
 
 	void InitGlobalSettings(DataChangeSource changeSource, String ipAddress, int rate);
+	void InitDeviceTable(DataChangeSource changeSource, const StringArray& ipAddresses);
 
 	void DisconnectOsc();
 	void ReconnectOsc();
-	bool GetOnline() const;
+	bool GetOnline(DeviceId deviceId = 0) const;
+
+	bool GetLowLatencyMode() const;
+	void SetLowLatencyMode(bool enabled);
+
+	int GetPollBudget(DeviceId deviceId = 0) const;
+	void SetPollBudget(int budget, DeviceId deviceId = 0);
+	int GetPollRefreshInterval(DeviceId deviceId = 0) const;
 
-	void oscMessageReceived(const OSCMessage &message) override;
-	bool SendOSCMessage(OSCMessage message);
+	int GetMtu(DeviceId deviceId = 0) const;
+	void SetMtu(int mtu, DeviceId deviceId = 0);
+	int GetTxPacketsPerTick(DeviceId deviceId = 0) const;
+	int GetTxMessagesPerTick(DeviceId deviceId = 0) const;
+	static int GetTickJitterBinLimit(int bin);
+	int GetTickJitterCount(int bin) const;
+	void ResetTickJitterHistogram();
+	CProfiledMutex::Profile GetLockProfile(LockDomain domain) const;
+	void ResetLockProfiles();
+
+	int GetTxQueuedPackets(DeviceId deviceId = 0) const;
+	int GetTxDroppedPackets(DeviceId deviceId = 0) const;
+	int GetTxFailedPackets(DeviceId deviceId = 0) const;
 
 private:
-	void timerCallback() override;
+	void hiResTimerCallback() override;
+	void handleAsyncUpdate() override;
+	void oscDatagramReceived(const char* data, int size, uint32 senderAddress) override;
+	void oscMessageDecoded(const COscMessageView& message) override;
+	DeviceId GetOnlyUsedDevice() const;
+	void ApplyReceivedValues();
+	void ApplyReceivedValue(CPlugin* plugin, OscCommand command, float value1, float value2);
+	void UpdateTickJitter();
+	void LogLockProfiles() const;
+	void SendQueuedSetCommands();
+	void PushQueuedProcessor(ProcessorQueue queue, CPlugin* p);
+	void UnqueueProcessor(CPlugin* p);
+	static bool IsValidDeviceId(DeviceId deviceId);
+	Array<CPlugin*>& GetSourceRoute(DeviceId deviceId, SourceId sourceId);
+	void UpdateSourceIdInUse(DeviceId deviceId, SourceId sourceId);
+	void PublishProcessorSnapshot();
+	SourceId GetFreeSourceId(DeviceId deviceId) const;
 
 protected:
 	/**
@@ -104,51 +333,198 @@ protected:
 	 * When adding Plug-in instances to a project (i.e. one for each DAW track), this list will grow.
 	 * When removing Plug-in instances from a project, this list will shrink. When the list becomes empty,
 	 * The CController singleton object is no longer necessary and will destruct itself.
+	 * The list is kept dense for fast iteration, so the order of its entries changes when Plug-ins are removed.
+	 * Use the stable PluginIds to refer to a specific Plug-in, see GetProcessorById().
 	 */
 	Array<CPlugin*>			m_processors;
 
 	/**
-	 * An OSCSender object can connect to a network port. It then can send OSC
-	 * messages and bundles to a specified host over an UDP socket.
+	 * PluginId of each entry of m_processors, at the same index.
+	 */
+	Array<PluginId>			m_processorIds;
+
+	/**
+	 * Entry of the slot map which resolves PluginIds. A PluginId combines the index of its slot with the 
+	 * slot's generation, which is advanced whenever a Plug-in is removed, so that stale PluginIds no longer resolve.
+	 */
+	struct ProcessorSlot
+	{
+		CPlugin*	processor = nullptr;	//< Plug-in currently registered in this slot, if any.
+		int			index = -1;				//< Index of the Plug-in within m_processors.
+		PluginId	generation = 0;			//< Generation of the slot, see PLUGIN_ID_SLOT_BITS.
+	};
+
+	/**
+	 * Slot map of registered Plug-ins, indexed by the slot part of their PluginId.
+	 */
+	Array<ProcessorSlot>	m_processorSlots;
+
+	/**
+	 * Indices of the unused entries of m_processorSlots, which are reused by AddProcessor() before the map grows.
+	 */
+	Array<int>				m_freeProcessorSlots;
+
+	/**
+	 * Immutable copy of the registered Plug-ins, replaced whenever m_processors changes, see GetProcessorSnapshot().
+	 */
+	CProcessorSnapshot::Ptr	m_processorSnapshot;
+
+	/**
+	 * Guards swapping and copying m_processorSnapshot only. It is never held for longer than a reference count
+	 * update, so readers do not contend with the timer thread for m_registryMutex.
+	 */
+	SpinLock				m_processorSnapshotLock;
+
+	/**
+	 * Plug-ins bound to each SourceId of each device, so that received values can be routed
+	 * without scanning m_processors. Usually only one Plug-in is bound to a SourceId, but several 
+	 * may share it. Indexed by DeviceId and (SourceId - SOURCE_ID_MIN), see GetSourceRoute().
 	 */
-	OSCSender				m_oscSender;
+	Array<CPlugin*>			m_sourceRoutes[DEVICE_COUNT_MAX][SOURCE_ID_MAX];
 
 	/**
-	 * An OSCReceiver object can connect to a network port, receive incoming OSC packets from the network
-	 * via UDP, parse them, and forward the included OSCMessage and OSCBundle objects to its listeners.
+	 * Occupancy bitmap of the SourceIds of each device. Bit (SourceId - SOURCE_ID_MIN) is set while at least
+	 * one Plug-in is bound to that SourceId, i.e. while its entry in m_sourceRoutes is not empty.
+	 * See UpdateSourceIdInUse() and GetFreeSourceId().
 	 */
-	OSCReceiver				m_oscReceiver;
+	uint64					m_sourceIdsInUse[DEVICE_COUNT_MAX];
 
 	/**
-	 * IP Address where OSC messages will be sent to / received from.
+	 * Heads of the intrusive, lock-free lists of processors which need to be visited, see enum ProcessorQueue.
+	 * PQ_Tick holds the processors to visit during the next timer tick, i.e. because they have changed parameters 
+	 * or are polling the DS100. PQ_Set holds the processors with changes for the low-latency path.
+	 * Linked through CPlugin::GetNextQueued(). See QueueProcessorForTick() and QueueProcessorForSet().
 	 */
-	String					m_ipAddress;
+	std::atomic<CPlugin*>	m_queuedProcessors[PQ_Max];
 
 	/**
-	 * Interval at which OSC messages are sent to the host, in ms.
+	 * Device table. Each entry has its own IP address, socket, send scheduler, request budget and online state.
+	 * Device 0 is the one configured by the IP address field which existed before multi-device support,
+	 * all other entries stay unused until an IP address is assigned to them.
 	 */
-	int						m_oscMsgRate;
+	CDevice					m_devices[DEVICE_COUNT_MAX];
+
+	/**
+	 * IP address of each entry of the device table, as returned by GetIpAddress(). Written while holding both
+	 * m_sendMutex and m_registryMutex, so the GUI can read it with m_registryMutex alone, which the timer tick does not hold.
+	 */
+	String					m_ipAddresses[DEVICE_COUNT_MAX];
+
+	/**
+	 * Thread which owns the UDP socket on which all devices send their replies, and decodes them right away.
+	 * Replies are assigned to a device by their sender's IP address, see oscDatagramReceived().
+	 */
+	COscReceiveThread		m_oscReceiveThread;
+
+	/**
+	 * Device which sent the datagram currently being decoded, see oscMessageDecoded(). Only used on m_oscReceiveThread.
+	 */
+	CDevice*				m_rxDevice;
+
+	/**
+	 * Number of received datagrams whose sender was not found in the device table, see oscDatagramReceived().
+	 */
+	std::atomic<int>		m_unmatchedDatagrams;
+
+	/**
+	 * Number of received messages whose address pattern was not recognized, see oscMessageDecoded().
+	 */
+	std::atomic<int>		m_unparsedMessages;
+
+	/**
+	 * Interval at which OSC messages are sent to the host, in ms. Changed while holding m_sendMutex, 
+	 * but atomic so that it can be read without waiting for a running timer tick.
+	 */
+	std::atomic<int>		m_oscMsgRate;
+
+	/**
+	 * Time of the last timer tick, in milliseconds. See Time::getMillisecondCounterHiRes().
+	 */
+	double					m_lastTickTime;
+
+	/**
+	 * Time at which received values were last handed over to the message thread, in milliseconds. See ApplyReceivedValues().
+	 */
+	double					m_lastApplyTime;
+
+	/**
+	 * Set by ApplyReceivedValues() once it has applied all values received so far, and taken by the next timer tick,
+	 * which then clears the Plug-ins' in-transit flags. See CPlugin::ClearParamInTransit().
+	 */
+	std::atomic<bool>		m_receivedValuesApplied;
+
+	/**
+	 * A received value, and the Plug-in to which it is to be applied. See ApplyReceivedValues().
+	 */
+	struct ReceivedValue
+	{
+		CPlugin*	plugin;		//< Plug-in bound to the device and SourceId of the value.
+		OscCommand	command;	//< OscCommand to which the value belongs.
+		float		value1;		//< Received value, or X coordinate.
+		float		value2;		//< Y coordinate, only relevant for OscCmd_SourcePositionXY.
+	};
+
+	/**
+	 * Values collected by ApplyReceivedValues() while holding m_registryMutex, which are then applied without
+	 * holding any lock. Only accessed on the message thread. Storage is kept between calls.
+	 */
+	Array<ReceivedValue>	m_receivedValues;
+
+	/**
+	 * Histogram of the deviation of actual tick periods from m_oscMsgRate. 
+	 * Bin limits are given by GetTickJitterBinLimit().
+	 */
+	std::atomic<int>		m_tickJitterHistogram[TICK_JITTER_BINS];
+
+	/**
+	 * Largest deviation of an actual tick period from m_oscMsgRate since the last reset, in microseconds.
+	 */
+	std::atomic<int>		m_tickJitterMax;
+
+	/**
+	 * True if local parameter changes are sent out over the low-latency path. See SetLowLatencyMode().
+	 */
+	std::atomic<bool>		m_lowLatencyMode;
+
+	/**
+	 * Deadline after which the changes queued on PQ_Set are sent out. See SendQueuedSetCommands().
+	 */
+	CDeadlineTimer			m_setDeadline;
 
 	/**
 	 * Keep track of which OSC parameters have changed recently. 
 	 * The array has one entry for each application module (see enum DataChangeSource).
+	 * The flags are atomic, so they can be set and popped from any thread without locking.
+	 */
+	std::atomic<DataChangeTypes>	m_parametersChanged[DCS_Max];
+
+	/**
+	 * Generation counter of each global setting, see kGlobalSettings. Advanced on every change of the setting, 
+	 * so consumers can detect changes by comparing with the generation they last saw.
+	 */
+	std::atomic<uint32>		m_globalGenerations[GLOBAL_SETTING_COUNT];
+
+	/**
+	 * GUI components to wake when data changes, see NotifyChangeSubscribers().
 	 */
-	DataChangeTypes				m_parametersChanged[DCS_Max];
+	Array<AChangeSubscriber*>	m_changeSubscribers;
 
 	/**
-	 * Number of timer intervals since the last successful OSC message was received.
+	 * Protects m_changeSubscribers. Separate from the other locks, so that notifications never wait for a timer tick.
 	 */
-	int						m_heartBeatsRx;
+	CriticalSection			m_subscriberMutex;
 
 	/**
-	 * Number of timer intervals since the last OSC message was sent out.
+	 * Guards the timer tick, the low-latency SET commands, and the device table (see LD_Send). 
+	 * Held for the whole tick, so that Plug-ins are not removed while being visited.
 	 */
-	int						m_heartBeatsTx;
+	CProfiledMutex			m_sendMutex;
 
 	/**
-	 * A re-entrant mutex. Safety first.
+	 * Guards m_processors and the slot map, m_sourceRoutes, m_sourceIdsInUse, and m_ipAddresses (see LD_Registry).
+	 * Taken after m_sendMutex, where both are needed.
 	 */
-	CriticalSection			m_mutex;
+	CProfiledMutex			m_registryMutex;
 
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CController)
 };
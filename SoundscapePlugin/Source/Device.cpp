@@ -0,0 +1,851 @@
+/*
+===============================================================================
+
+Copyright (C) 2019 d&b audiotechnik GmbH & Co. KG. All Rights Reserved.
+
+This file is part of the Soundscape VST, AU, and AAX Plug-in.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY d&b audiotechnik GmbH & Co. KG "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+===============================================================================
+*/
+
+
+#include "Device.h"
+#include "PluginProcessor.h"
+
+#if JUCE_WINDOWS
+ #include <winsock2.h>
+ #include <ws2tcpip.h>
+#else
+ #include <sys/socket.h>
+ #include <netinet/in.h>
+ #include <netdb.h>
+#endif
+
+
+namespace dbaudio
+{
+
+
+static constexpr int RX_PORT_DS100 = 50010;		//< UDP port which the DS100 is listening to for OSC
+
+static constexpr int KEEPALIVE_TIMEOUT = 5000;	//< Milliseconds without response after which we consider plugin "Offline"
+static constexpr int KEEPALIVE_INTERVAL = 1500;	//< Interval at which keepalive (ping) messages are sent, in milliseconds
+static constexpr int MAX_HEARTBEAT_COUNT = 0xFFFF;	//< No point counting beyond this number.
+
+static constexpr int OSC_MTU_MIN = 256;			//< Smallest supported datagram size for outgoing OSC bundles, in bytes
+static constexpr int OSC_MTU_MAX = COscEncoder::MAX_PACKET_SIZE;	//< Largest possible UDP payload over IPv4, in bytes
+static constexpr int OSC_MTU_DEF = 1472;		//< Ethernet MTU (1500) minus IPv4 and UDP headers, in bytes
+
+static constexpr int POLL_BUDGET_MIN = 50;		//< Minimum request budget towards the DS100, in messages per second
+static constexpr int POLL_BUDGET_MAX = 10000;	//< Maximum request budget towards the DS100, in messages per second
+static constexpr int POLL_BUDGET_DEF = 1000;	//< Default request budget towards the DS100, in messages per second
+static constexpr int POLL_STATS_WINDOW = 1000;	//< Interval over which the effective refresh interval is averaged, in milliseconds
+
+
+/**
+ * Pre-defined OSC command strings
+ */
+static const char kOscAddress_ping[] = "/ping\0\0";	//< "/ping", null-terminated and padded to 8 bytes
+
+
+/**
+ * Change flag belonging to the parameter(s) addressed by each OSC command, see enum OscCommand.
+ */
+static constexpr DataChangeTypes kOscCommandChangeTypes[OscCmd_MaxIndex] = 
+{
+	DCT_SourcePosition,
+	DCT_ReverbSendGain,
+	DCT_SourceSpread,
+	DCT_DelayMode
+};
+
+
+/**
+ * Helper which defines the order in which polling Plug-ins are served by CDevice::SendPollRequests(): 
+ * by SourceId, and by object address for Plug-ins sharing the same SourceId.
+ * NOTE: The pointers are only compared, never dereferenced.
+ * @param sourceIdA	SourceId of the first Plug-in.
+ * @param a			First Plug-in.
+ * @param sourceIdB	SourceId of the second Plug-in.
+ * @param b			Second Plug-in.
+ * @return	True if the first Plug-in is served before the second one.
+ */
+static bool IsPolledBefore(SourceId sourceIdA, const CPlugin* a, SourceId sourceIdB, const CPlugin* b)
+{
+	if (sourceIdA != sourceIdB)
+		return (sourceIdA < sourceIdB);
+	return std::less<const CPlugin*>()(a, b);
+}
+
+
+/**
+ * Helper to convert an IP address into the value stored in CDevice::m_rxAddress.
+ * @param ipAddress	The IP address.
+ * @return	The IPv4 address in host byte order, or 0 for IPv6 and unspecified addresses.
+ */
+static uint32 GetRxAddressValue(const IPAddress& ipAddress)
+{
+	if (ipAddress.isIPv6)
+		return 0;
+
+	return ((static_cast<uint32>(ipAddress.address[0]) << 24) |
+			(static_cast<uint32>(ipAddress.address[1]) << 16) |
+			(static_cast<uint32>(ipAddress.address[2]) << 8) |
+			static_cast<uint32>(ipAddress.address[3]));
+}
+
+
+/*
+===============================================================================
+ Class CSourceStateTable
+===============================================================================
+*/
+
+static_assert(SOURCE_ID_MAX <= 64, "CSourceStateTable uses one bit per SourceId in a 64 bit mask");
+
+/**
+ * Object constructor. All values start out at zero, with nothing pending.
+ */
+CSourceStateTable::CSourceStateTable()
+{
+	for (int slot = 0; slot < SLOT_COUNT; ++slot)
+	{
+		for (int i = 0; i < SOURCE_ID_MAX; ++i)
+		{
+			m_entries[slot][i].sequence = 0;
+			m_entries[slot][i].value1 = 0.0f;
+			m_entries[slot][i].value2 = 0.0f;
+		}
+		m_pending[slot] = 0;
+	}
+}
+
+/**
+ * Object destructor.
+ */
+CSourceStateTable::~CSourceStateTable()
+{
+}
+
+/**
+ * Map an OscCommand to its slot within the table.
+ * @param command	The OscCommand.
+ * @param mappingId	Coordinate mapping, only relevant for OscCmd_SourcePositionXY.
+ * @return	Index of the slot.
+ */
+int CSourceStateTable::GetSlot(OscCommand command, int mappingId)
+{
+	if (command == OscCmd_SourcePositionXY)
+		return (mappingId - MAPPING_ID_MIN);
+
+	return (MAPPING_ID_MAX + command - 1);
+}
+
+/**
+ * Store a received value, overwriting any previous value which has not been taken yet. Called on the receive thread.
+ * @param command	The OscCommand which the response belongs to.
+ * @param sourceId	SourceId of the response.
+ * @param mappingId	Coordinate mapping, only relevant for OscCmd_SourcePositionXY.
+ * @param value1	Received value, or X coordinate.
+ * @param value2	Y coordinate, only relevant for OscCmd_SourcePositionXY.
+ */
+void CSourceStateTable::Publish(OscCommand command, SourceId sourceId, int mappingId, float value1, float value2)
+{
+	jassert((sourceId >= SOURCE_ID_MIN) && (sourceId <= SOURCE_ID_MAX));
+	jassert((command != OscCmd_SourcePositionXY) || ((mappingId >= MAPPING_ID_MIN) && (mappingId <= MAPPING_ID_MAX)));
+
+	int slot = GetSlot(command, mappingId);
+	Entry& entry = m_entries[slot][sourceId - SOURCE_ID_MIN];
+
+	uint32 sequence = entry.sequence.load(std::memory_order_relaxed);
+	entry.sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	entry.value1.store(value1, std::memory_order_relaxed);
+	entry.value2.store(value2, std::memory_order_relaxed);
+	entry.sequence.store(sequence + 2, std::memory_order_release);
+
+	m_pending[slot].fetch_or(static_cast<uint64>(1) << (sourceId - SOURCE_ID_MIN), std::memory_order_release);
+}
+
+/**
+ * Take the set of sources for which new values have arrived since the last call.
+ * @param command	The OscCommand in question.
+ * @param mappingId	Coordinate mapping, only relevant for OscCmd_SourcePositionXY.
+ * @return	Bitmask with one bit per SourceId, starting with SOURCE_ID_MIN at bit 0.
+ */
+uint64 CSourceStateTable::TakePending(OscCommand command, int mappingId)
+{
+	return m_pending[GetSlot(command, mappingId)].exchange(0, std::memory_order_acquire);
+}
+
+/**
+ * Read the latest value stored for a source. If the receive thread is writing the same entry 
+ * at the same time, the read is simply repeated.
+ * @param command	The OscCommand in question.
+ * @param sourceId	SourceId in question.
+ * @param mappingId	Coordinate mapping, only relevant for OscCmd_SourcePositionXY.
+ * @param value1	Returns the received value, or X coordinate.
+ * @param value2	Returns the Y coordinate, only relevant for OscCmd_SourcePositionXY.
+ */
+void CSourceStateTable::Read(OscCommand command, SourceId sourceId, int mappingId, float& value1, float& value2) const
+{
+	const Entry& entry = m_entries[GetSlot(command, mappingId)][sourceId - SOURCE_ID_MIN];
+
+	uint32 before;
+	uint32 after;
+	do
+	{
+		before = entry.sequence.load(std::memory_order_acquire);
+		value1 = entry.value1.load(std::memory_order_relaxed);
+		value2 = entry.value2.load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		after = entry.sequence.load(std::memory_order_relaxed);
+	} while (((before & 1) != 0) || (before != after));
+}
+
+/**
+ * Forget about all values which have not been taken yet, i.e. after the device's IP address has changed.
+ */
+void CSourceStateTable::ClearPending()
+{
+	for (int slot = 0; slot < SLOT_COUNT; ++slot)
+		m_pending[slot] = 0;
+}
+
+
+/*
+===============================================================================
+ Class CDevice
+===============================================================================
+*/
+
+/**
+ * Object constructor. The device starts out unused, without an IP address, and offline.
+ */
+CDevice::CDevice()
+	: m_rxAddress(0),
+	m_used(false),
+	m_responseReceived(false),
+	m_txEncoder(this, OSC_MTU_DEF),
+	m_pollBudget(POLL_BUDGET_DEF),
+	m_pollTokens(0.0),
+	m_pollCursorSourceId(0),
+	m_pollCursorProcessor(nullptr),
+	m_pollCursorCommand(0),
+	m_pollDemandCount(0),
+	m_pollServedCount(0),
+	m_pollWindowTicks(0),
+	m_pollWindowStart(0.0),
+	m_pollRefreshInterval(0),
+	m_setCommandsSent(false),
+	m_txPacketCount(0),
+	m_txMessageCount(0),
+	m_txPacketsPerTick(0),
+	m_txMessagesPerTick(0),
+	m_heartBeatsRx(MAX_HEARTBEAT_COUNT),
+	m_heartBeatsTx(0)
+{
+}
+
+/**
+ * Object destructor.
+ */
+CDevice::~CDevice()
+{
+	Disconnect();
+}
+
+/**
+ * Getter function for the IP address of the DS100.
+ * @return	Current IP address, or an empty string if the device is unused.
+ */
+String CDevice::GetIpAddress() const
+{
+	return m_ipAddress;
+}
+
+/**
+ * Setter function for the IP address of the DS100. The device goes "offline" until it responds
+ * at the new address, and is reconnected unless the address is empty.
+ * @param ipAddress		New IP address or host name, or an empty string to leave the device unused.
+ * @param rxAddress		The result of ResolveRxAddress() for ipAddress. Resolved by the caller, so that
+ *						looking up a host name does not block while the CController's mutex is held.
+ */
+void CDevice::SetIpAddress(const String& ipAddress, uint32 rxAddress)
+{
+	m_ipAddress = ipAddress;
+	m_rxAddress = ipAddress.isNotEmpty() ? rxAddress : 0;
+	m_used = ipAddress.isNotEmpty();
+
+	// Start "offline" after changing IP address, and drop whatever was received from the previous address.
+	m_heartBeatsRx = MAX_HEARTBEAT_COUNT;
+	m_heartBeatsTx = 0;
+	m_responseReceived = false;
+	m_rxState.ClearPending();
+
+	Connect();
+}
+
+/**
+ * Check whether this entry of the device table has an IP address assigned. Called on the receive thread.
+ * @return	True if the device is in use, even if its host name could not be resolved.
+ */
+bool CDevice::IsUsed() const
+{
+	return m_used;
+}
+
+/**
+ * Convert an IP address or host name into the value stored in m_rxAddress, which is compared against
+ * the sender of received datagrams. Dotted IPv4 addresses are converted directly, anything else
+ * is looked up via the system resolver, which may block.
+ * @param ipAddress		IP address or host name of the DS100.
+ * @return	The first IPv4 address of the host in host byte order, or 0 if it could not be resolved.
+ */
+uint32 CDevice::ResolveRxAddress(const String& ipAddress)
+{
+	if (ipAddress.isEmpty())
+		return 0;
+
+	uint32 rxAddress = GetRxAddressValue(IPAddress(ipAddress));
+	if (rxAddress != 0)
+		return rxAddress;
+
+#if JUCE_WINDOWS
+	// getaddrinfo() requires Winsock, which JUCE only initialises once its first socket is created.
+	static const bool winsockReady = []
+	{
+		WSADATA wsaData;
+		return (WSAStartup(MAKEWORD(2, 2), &wsaData) == 0);
+	}();
+	if (!winsockReady)
+		return 0;
+#endif
+
+	struct addrinfo hints = {};
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_DGRAM;
+
+	struct addrinfo* info = nullptr;
+	if ((getaddrinfo(ipAddress.toRawUTF8(), nullptr, &hints, &info) != 0) || (info == nullptr))
+		return 0;
+
+	const struct sockaddr_in* address = reinterpret_cast<const struct sockaddr_in*>(info->ai_addr);
+	rxAddress = static_cast<uint32>(ntohl(address->sin_addr.s_addr));
+	freeaddrinfo(info);
+
+	return rxAddress;
+}
+
+/**
+ * Re-open the sending socket, after the ip settings have changed. 
+ * Unused devices, which have no IP address, are only disconnected.
+ */
+void CDevice::Connect()
+{
+	Disconnect();
+
+	if (m_ipAddress.isNotEmpty())
+	{
+		// Start the sending thread, which opens its socket on any free local port.
+		bool ok = m_oscSendThread.Start(m_ipAddress, RX_PORT_DS100);
+		jassert(ok);
+		ignoreUnused(ok);
+	}
+}
+
+/**
+ * Stop the sending thread.
+ */
+void CDevice::Disconnect()
+{
+	m_oscSendThread.Stop();
+}
+
+/**
+ * Check whether packets are currently being sent to the DS100.
+ * @return	True if the sending thread is running.
+ */
+bool CDevice::IsConnected() const
+{
+	return m_oscSendThread.IsRunning();
+}
+
+/**
+ * Getter function for the OSC communication state.
+ * @param rate	Current timer interval, in milliseconds.
+ * @return		True if a valid OSC message was received and successfully processed recently.
+ *				False if no response was received for longer than the timeout threshold.
+ */
+bool CDevice::GetOnline(int rate) const
+{
+	return ((m_heartBeatsRx * rate) < KEEPALIVE_TIMEOUT);
+}
+
+/**
+ * Check whether a received datagram was sent by this DS100. Called on the receive thread.
+ * @param senderAddress	IPv4 address of the sender in host byte order, as passed by COscReceiveThread.
+ * @return	True if the device is in use, and has the given IP address.
+ */
+bool CDevice::HasAddress(uint32 senderAddress) const
+{
+	uint32 rxAddress = m_rxAddress;
+	return ((rxAddress != 0) && (rxAddress == senderAddress));
+}
+
+/**
+ * Signal that a valid OSC message was received from the DS100. Called on the receive thread. 
+ * The number of heartbeats since the last response is reset during the next timer tick, see EndTick().
+ */
+void CDevice::ResponseReceived()
+{
+	m_responseReceived = true;
+}
+
+/**
+ * Getter for the latest values received from the DS100, which have yet to be applied to the Plug-ins.
+ * @return	The table of received values.
+ */
+CSourceStateTable& CDevice::GetReceivedValues()
+{
+	return m_rxState;
+}
+
+/**
+ * Getter for the request budget towards the DS100.
+ * @return	Maximum number of OSC messages sent per second, of which GET commands may use whatever SET commands leave over.
+ */
+int CDevice::GetPollBudget() const
+{
+	return m_pollBudget;
+}
+
+/**
+ * Setter for the request budget towards the DS100.
+ * @param budget	Maximum number of OSC messages per second.
+ */
+void CDevice::SetPollBudget(int budget)
+{
+	m_pollBudget = jmin(POLL_BUDGET_MAX, jmax(POLL_BUDGET_MIN, budget));
+}
+
+/**
+ * Effective interval at which the parameters of each polling source are requested from the DS100.
+ * @return	Refresh interval in milliseconds, or 0 if no Plug-in is currently polling.
+ */
+int CDevice::GetPollRefreshInterval() const
+{
+	return m_pollRefreshInterval;
+}
+
+/**
+ * Getter for the maximum size of outgoing UDP datagrams.
+ * @return	Maximum datagram size, in bytes.
+ */
+int CDevice::GetMtu() const
+{
+	return m_txEncoder.GetMaxPacketSize();
+}
+
+/**
+ * Setter for the maximum size of outgoing UDP datagrams.
+ * @param mtu	New maximum datagram size, in bytes.
+ */
+void CDevice::SetMtu(int mtu)
+{
+	m_txEncoder.SetMaxPacketSize(jmin(OSC_MTU_MAX, jmax(OSC_MTU_MIN, mtu)));
+}
+
+/**
+ * Number of UDP datagrams which were sent out to this device during the last timer tick.
+ * @return	Number of datagrams sent during the last tick.
+ */
+int CDevice::GetTxPacketsPerTick() const
+{
+	return m_txPacketsPerTick;
+}
+
+/**
+ * Number of OSC messages which were sent out to this device during the last timer tick.
+ * @return	Number of messages sent during the last tick.
+ */
+int CDevice::GetTxMessagesPerTick() const
+{
+	return m_txMessagesPerTick;
+}
+
+/**
+ * Number of UDP datagrams which are currently waiting in the send queue.
+ * @return	Current send queue depth, in datagrams.
+ */
+int CDevice::GetTxQueuedPackets() const
+{
+	return m_oscSendThread.GetQueuedPackets();
+}
+
+/**
+ * Number of UDP datagrams which were discarded because the send queue was full.
+ * @return	Total number of dropped datagrams.
+ */
+int CDevice::GetTxDroppedPackets() const
+{
+	return m_oscSendThread.GetDroppedPackets();
+}
+
+/**
+ * Number of UDP datagrams which the send thread failed to write to its socket.
+ * @return	Total number of failed datagrams.
+ */
+int CDevice::GetTxFailedPackets() const
+{
+	return m_oscSendThread.GetFailedPackets();
+}
+
+/**
+ * Start a new timer tick: add request tokens to the budget according to the time which has passed 
+ * since the last tick, and start over with an empty list of polling Plug-ins.
+ * Unused tokens are kept for two timer intervals at most, so that a late tick can catch up, but idle
+ * periods cannot build up a burst.
+ * @param elapsed	Time since the last timer tick, in milliseconds.
+ * @param rate		Current timer interval, in milliseconds.
+ */
+void CDevice::BeginTick(double elapsed, int rate)
+{
+	double tokensPerTick = (m_pollBudget * rate) / 1000.0;
+	m_pollTokens = jmin(m_pollTokens + ((m_pollBudget * elapsed) / 1000.0), jmax(1.0, 2.0 * tokensPerTick));
+
+	m_pollingProcessors.clearQuick();
+	m_setCommandsSent = false;
+}
+
+/**
+ * Add SET commands for all parameters of a Plug-in which have changed since they were last sent, 
+ * provided that the Plug-in is in CM_Tx mode. The DCS_Osc change flags of these parameters are reset.
+ * Parameters which are sent are polled at full rate again.
+ * @param pro	The Plug-in whose changed parameters should be sent.
+ * @return	The parameters for which a SET command was added.
+ */
+DataChangeTypes CDevice::SendSetCommands(CPlugin* pro)
+{
+	DataChangeTypes paramSetsSent = DCT_None;
+
+	// SET commands are only sent out while in CM_Tx mode.
+	if ((pro->GetComsMode() & CM_Tx) != CM_Tx)
+		return paramSetsSent;
+
+	const COscAddressCache& addresses = pro->GetOscAddressCache();
+
+	// Iterate through all automation parameters. A SET command is only added for a parameter which has been changed
+	// since it was last sent. Its flag is reset before the value is read, so that a change made in the meantime is 
+	// sent the next time, see PopSetCommand().
+	for (int pIdx = ParamIdx_X; pIdx < ParamIdx_MaxIndex; ++pIdx)
+	{
+		switch (pIdx)
+		{
+			case ParamIdx_X:
+				if (PopSetCommand(pro, DCT_SourcePosition, paramSetsSent))
+					m_txEncoder.AddMessage(addresses.GetAddress(OscCmd_SourcePositionXY), addresses.GetAddressSize(OscCmd_SourcePositionXY), pro->GetParameterValue(ParamIdx_X), pro->GetParameterValue(ParamIdx_Y));
+				break;
+
+			case ParamIdx_Y:
+				// Changes to ParamIdx_Y are handled together with ParamIdx_X, so skip it.
+				break;
+
+			case ParamIdx_ReverbSendGain:
+				if (PopSetCommand(pro, DCT_ReverbSendGain, paramSetsSent))
+					m_txEncoder.AddMessage(addresses.GetAddress(OscCmd_ReverbSendGain), addresses.GetAddressSize(OscCmd_ReverbSendGain), pro->GetParameterValue(ParamIdx_ReverbSendGain));
+				break;
+
+			case ParamIdx_SourceSpread:
+				if (PopSetCommand(pro, DCT_SourceSpread, paramSetsSent))
+					m_txEncoder.AddMessage(addresses.GetAddress(OscCmd_SourceSpread), addresses.GetAddressSize(OscCmd_SourceSpread), pro->GetParameterValue(ParamIdx_SourceSpread));
+				break;
+
+			case ParamIdx_DelayMode:
+				if (PopSetCommand(pro, DCT_DelayMode, paramSetsSent))
+					m_txEncoder.AddMessage(addresses.GetAddress(OscCmd_SourceDelayMode), addresses.GetAddressSize(OscCmd_SourceDelayMode), static_cast<int>(pro->GetParameterValue(ParamIdx_DelayMode)));
+				break;
+
+			case ParamIdx_Bypass:
+				// Nothing to do, this is not a parameter which will arrive per OSC.
+				break;
+
+			default:
+				jassertfalse;
+				break;
+		}
+	}
+
+	if (paramSetsSent != DCT_None)
+	{
+		// Since we are expecting at least one response from the DS100, 
+		// we can use that as heartbeat, no need to send an extra ping.
+		m_setCommandsSent = true;
+
+		// Locally changed parameters are active, so poll them at full rate again.
+		for (int cmd = 0; cmd < OscCmd_MaxIndex; ++cmd)
+			if ((paramSetsSent & kOscCommandChangeTypes[cmd]) != DCT_None)
+				pro->SetPollActivity(static_cast<OscCommand>(cmd), true);
+	}
+
+	return paramSetsSent;
+}
+
+/**
+ * Reset the DCS_Osc change flag of a Plug-in's parameter, in order to add a SET command for it.
+ * SET commands always go out, but each one counts against the budget available for GET commands.
+ * @param pro				The Plug-in whose parameter should be sent.
+ * @param changeType		The parameter's DataChangeType.
+ * @param paramSetsSent		Parameters for which a SET command has been added. changeType is added if the parameter had changed.
+ * @return	True if the parameter had changed, and its SET command should be added now.
+ */
+bool CDevice::PopSetCommand(CPlugin* pro, DataChangeTypes changeType, DataChangeTypes& paramSetsSent)
+{
+	if (!pro->PopParameterChanged(DCS_Osc, changeType))
+		return false;
+
+	m_pollTokens = jmax(0.0, m_pollTokens - 1.0);
+	paramSetsSent |= changeType;
+
+	return true;
+}
+
+/**
+ * Add a Plug-in to the list of Plug-ins for which GET commands are sent at the end of the current timer tick.
+ * @param pro	The polling Plug-in.
+ */
+void CDevice::AddPollingProcessor(CPlugin* pro)
+{
+	m_pollingProcessors.add(pro);
+}
+
+/**
+ * Finish the current timer tick: send out GET commands within the request budget, a ping if nothing else 
+ * is expected to trigger a response, and whatever else is left of this tick's messages. 
+ * @param rate	Current timer interval, in milliseconds.
+ * @return	DCT_Online and/or DCT_RefreshInterval, if the online state or the refresh interval have changed.
+ */
+DataChangeTypes CDevice::EndTick(int rate)
+{
+	DataChangeTypes changes = DCT_None;
+
+	// A valid OSC message was received since the last tick -> reset the number of heartbeats since last response.
+	if (m_responseReceived.exchange(false))
+	{
+		// If previous state was "Offline", all plugins need to update their GUI, since we are now Online.
+		if (!GetOnline(rate))
+			changes |= DCT_Online;
+		m_heartBeatsRx = 0;
+	}
+
+	// Nothing to send out to an unused device. Anything queued for it is discarded.
+	if (!IsConnected())
+	{
+		m_txEncoder.Flush();
+		return changes;
+	}
+
+	// Check that we don't flood the line with pings, only send them in small intervals.
+	bool sendKeepAlive = (((m_heartBeatsRx * rate) > KEEPALIVE_INTERVAL) ||
+							((m_heartBeatsTx * rate) > KEEPALIVE_INTERVAL));
+	if (m_setCommandsSent)
+		sendKeepAlive = false;
+
+	int refreshInterval = m_pollRefreshInterval;
+	if (SendPollRequests())
+		sendKeepAlive = false;
+	if (refreshInterval != m_pollRefreshInterval)
+		changes |= DCT_RefreshInterval;
+
+	if (sendKeepAlive)
+	{
+		// If we aren't expecting any responses from the DS100, we need to at least send a "ping"
+		// so that we can use the "pong" to check our connection status. 
+		// See handling of "pong" in CController::oscMessageDecoded()
+		m_txEncoder.AddMessage(kOscAddress_ping, static_cast<int>(sizeof(kOscAddress_ping)));
+	}
+
+	// Send out whatever is left of this tick's messages.
+	m_txEncoder.Flush();
+
+	// The counts are not logged here, since they change on nearly every tick. See GetTxPacketsPerTick() and GetTxMessagesPerTick().
+	m_txPacketsPerTick = m_txPacketCount;
+	m_txMessagesPerTick = m_txMessageCount;
+	m_txPacketCount = 0;
+	m_txMessageCount = 0;
+
+	bool wasOnline = GetOnline(rate);
+	if (m_heartBeatsRx < MAX_HEARTBEAT_COUNT)
+		m_heartBeatsRx++;
+	if (m_heartBeatsTx < MAX_HEARTBEAT_COUNT)
+		m_heartBeatsTx++;
+
+	// If we have just crossed the treshold, all plugins need to update their GUI, since we are now Offline.
+	if (wasOnline && (GetOnline(rate) == false))
+		changes |= DCT_Online;
+
+	return changes;
+}
+
+/**
+ * Send out all messages added since the last flush right away, i.e. for the low-latency path.
+ */
+void CDevice::Flush()
+{
+	m_txEncoder.Flush();
+}
+
+/**
+ * Send out GET commands for the Plug-ins collected in m_pollingProcessors, as far as the request budget allows.
+ * Requests are served round-robin over all sources and parameters, starting where the previous tick ran out of budget,
+ * so that every source is refreshed equally often regardless of the number of Plug-in instances.
+ * Parameters for which a SET command went out during this tick are not requested.
+ * @return	True if at least one GET command was sent.
+ */
+bool CDevice::SendPollRequests()
+{
+	const int numProcessors = m_pollingProcessors.size();
+	const int numSlots = numProcessors * OscCmd_MaxIndex;
+	const uint32 nowMs = Time::getMillisecondCounter();
+	int numRequired = 0;
+	int numSent = 0;
+
+	if (numSlots > 0)
+	{
+		// Bring the polling Plug-ins into a stable order, independent of the order in which they were queued.
+		std::sort(m_pollingProcessors.begin(), m_pollingProcessors.end(), [](const CPlugin* a, const CPlugin* b) 
+		{
+			return IsPolledBefore(a->GetSourceId(), a, b->GetSourceId(), b);
+		});
+
+		// Find the first request which could not be sent during the last tick.
+		int startProcessor = 0;
+		while ((startProcessor < numProcessors) && 
+			IsPolledBefore(m_pollingProcessors[startProcessor]->GetSourceId(), m_pollingProcessors[startProcessor], m_pollCursorSourceId, m_pollCursorProcessor))
+			startProcessor++;
+		int startSlot = 0;
+		if (startProcessor < numProcessors)
+		{
+			startSlot = startProcessor * OscCmd_MaxIndex;
+			if (m_pollingProcessors[startProcessor] == m_pollCursorProcessor)
+				startSlot += m_pollCursorCommand;
+		}
+
+		bool cursorSet = false;
+		for (int i = 0; i < numSlots; ++i)
+		{
+			int slot = (startSlot + i) % numSlots;
+			CPlugin* pro = m_pollingProcessors[slot / OscCmd_MaxIndex];
+			OscCommand cmd = static_cast<OscCommand>(slot % OscCmd_MaxIndex);
+
+			// X/Y coordinates are also polled in CM_PollOnce mode, all other parameters only in CM_Rx mode.
+			// Idle parameters are polled less often, see CPlugin::SetPollActivity().
+			ComsMode mode = pro->GetComsMode();
+			bool required = (cmd == OscCmd_SourcePositionXY) ? ((mode & (CM_Rx | CM_PollOnce)) != 0) : ((mode & CM_Rx) == CM_Rx);
+			if (!required || pro->IsParamInTransit(kOscCommandChangeTypes[cmd]) || !pro->IsPollDue(cmd, nowMs))
+				continue;
+
+			numRequired++;
+			if (m_pollTokens >= 1.0)
+			{
+				// GET command is just the OSC address pattern without parameters.
+				const COscAddressCache& addresses = pro->GetOscAddressCache();
+				m_txEncoder.AddMessage(addresses.GetAddress(cmd), addresses.GetAddressSize(cmd));
+				pro->SetPollSent(cmd, nowMs);
+				m_pollTokens -= 1.0;
+				numSent++;
+			}
+			else if (!cursorSet)
+			{
+				// Out of budget: the next tick continues with this request.
+				m_pollCursorSourceId = pro->GetSourceId();
+				m_pollCursorProcessor = pro;
+				m_pollCursorCommand = cmd;
+				cursorSet = true;
+			}
+		}
+	}
+
+	UpdatePollStatistics(numRequired, numSent);
+
+	return (numSent > 0);
+}
+
+/**
+ * Average the number of requests which were sent against the number of requests which were due,
+ * to determine how often each polled parameter actually gets refreshed.
+ * @param numRequired	Number of GET commands which were due during the current timer tick.
+ * @param numSent		Number of GET commands which were actually sent during the current timer tick.
+ */
+void CDevice::UpdatePollStatistics(int numRequired, int numSent)
+{
+	double now = Time::getMillisecondCounterHiRes();
+	if (m_pollWindowTicks == 0)
+		m_pollWindowStart = now;
+	m_pollDemandCount += numRequired;
+	m_pollServedCount += numSent;
+	m_pollWindowTicks++;
+	double windowLength = now - m_pollWindowStart;
+	if (windowLength >= POLL_STATS_WINDOW)
+	{
+		int refreshInterval = 0;
+		if (m_pollDemandCount > 0)
+		{
+			double requiredPerTick = static_cast<double>(m_pollDemandCount) / m_pollWindowTicks;
+			double tickLength = windowLength / m_pollWindowTicks;
+			refreshInterval = roundToInt(jmax(tickLength, (windowLength * requiredPerTick) / jmax(1, m_pollServedCount)));
+		}
+
+		m_pollRefreshInterval = refreshInterval;
+
+		m_pollDemandCount = 0;
+		m_pollServedCount = 0;
+		m_pollWindowTicks = 0;
+	}
+}
+
+/**
+ * Callback from m_txEncoder whenever an OSC packet is complete, either because it has reached 
+ * the configured MTU, or at the end of the timer tick.
+ * NOTE: Runs on the timer tick's or on the low-latency deadline's thread, always with the CController's send lock held.
+ * This keeps the two from ever enqueueing concurrently, as m_oscSendThread's queue requires.
+ * @param data			Pointer to the encoded packet.
+ * @param size			Size of the encoded packet, in bytes.
+ * @param numMessages	Number of OSC messages contained in the packet.
+ */
+void CDevice::oscPacketEncoded(const char* data, int size, int numMessages)
+{
+	if (m_oscSendThread.EnqueuePacket(data, size))
+	{
+		m_heartBeatsTx = 0;
+		m_txPacketCount++;
+		m_txMessageCount += numMessages;
+	}
+}
+
+
+} // namespace dbaudio
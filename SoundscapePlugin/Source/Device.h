@@ -0,0 +1,273 @@
+/*
+===============================================================================
+
+Copyright (C) 2019 d&b audiotechnik GmbH & Co. KG. All Rights Reserved.
+
+This file is part of the Soundscape VST, AU, and AAX Plug-in.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY d&b audiotechnik GmbH & Co. KG "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+===============================================================================
+*/
+
+
+#pragma once
+
+#include "Common.h"
+#include "OscCodec.h"
+#include "OscTransport.h"
+#include <atomic>
+
+
+namespace dbaudio
+{
+
+
+/**
+ * Forward declarations.
+ */
+class CPlugin;
+
+
+/**
+ * Class CSourceStateTable holds the latest values received from one DS100, for each of its sources and each
+ * of the parameters addressed by an OscCommand. X/Y coordinates are kept separately for each coordinate mapping.
+ * Values are written by the receive thread as soon as a response has been decoded, and are picked up by the 
+ * CController during its next timer tick. Neither side ever blocks the other: each entry is guarded by a 
+ * sequence counter, and one bitmask per parameter flags the sources for which new values have arrived.
+ * NOTE: There must only be one writing thread, and one reading thread.
+ */
+class CSourceStateTable
+{
+public:
+	CSourceStateTable();
+	~CSourceStateTable();
+
+	void Publish(OscCommand command, SourceId sourceId, int mappingId, float value1, float value2);
+	uint64 TakePending(OscCommand command, int mappingId);
+	void Read(OscCommand command, SourceId sourceId, int mappingId, float& value1, float& value2) const;
+	void ClearPending();
+
+private:
+	static int GetSlot(OscCommand command, int mappingId);
+
+	/**
+	 * Number of parameter slots: one per coordinate mapping for OscCmd_SourcePositionXY, one for each other OscCommand.
+	 */
+	static constexpr int SLOT_COUNT = MAPPING_ID_MAX + OscCmd_MaxIndex - 1;
+
+	/**
+	 * One received value (or X/Y pair).
+	 */
+	struct Entry
+	{
+		/**
+		 * Incremented before and after each write, so it is odd while the entry is being written.
+		 */
+		std::atomic<uint32>	sequence;
+		std::atomic<float>	value1;
+		std::atomic<float>	value2;
+	};
+
+	/**
+	 * Latest values for each slot and SourceId. Index 0 corresponds to SOURCE_ID_MIN.
+	 */
+	Entry					m_entries[SLOT_COUNT][SOURCE_ID_MAX];
+
+	/**
+	 * For each slot, one bit per SourceId whose value has been written since the last TakePending().
+	 */
+	std::atomic<uint64>		m_pending[SLOT_COUNT];
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CSourceStateTable)
+};
+
+
+/**
+ * Class CDevice holds everything the CController needs to communicate with one DS100: its IP address, 
+ * the thread and socket used to send to it, the encoder which packs outgoing messages into bundles,
+ * its request budget, and its online state. Plug-in instances are bound to a device by its index 
+ * within the CController's device table, see CPlugin::GetDeviceId().
+ * NOTE: CDevice is not thread-safe by itself. All calls are serialized by the CController's send lock, 
+ * except for HasAddress(), IsUsed(), ResponseReceived() and GetReceivedValues(), which are used by the receive thread,
+ * and GetOnline(), GetPollBudget(), GetPollRefreshInterval(), GetTxPacketsPerTick() and GetTxMessagesPerTick(),
+ * which only read atomics, so that the GUI does not wait for a running timer tick.
+ */
+class CDevice : private COscEncoder::Listener
+{
+public:
+	CDevice();
+	~CDevice() override;
+
+	String GetIpAddress() const;
+	void SetIpAddress(const String& ipAddress, uint32 rxAddress);
+	bool IsUsed() const;
+	static uint32 ResolveRxAddress(const String& ipAddress);
+	void Connect();
+	void Disconnect();
+	bool IsConnected() const;
+
+	bool GetOnline(int rate) const;
+	bool HasAddress(uint32 senderAddress) const;
+	void ResponseReceived();
+	CSourceStateTable& GetReceivedValues();
+
+	int GetPollBudget() const;
+	void SetPollBudget(int budget);
+	int GetPollRefreshInterval() const;
+
+	int GetMtu() const;
+	void SetMtu(int mtu);
+	int GetTxPacketsPerTick() const;
+	int GetTxMessagesPerTick() const;
+	int GetTxQueuedPackets() const;
+	int GetTxDroppedPackets() const;
+	int GetTxFailedPackets() const;
+
+	void BeginTick(double elapsed, int rate);
+	DataChangeTypes SendSetCommands(CPlugin* pro);
+	void AddPollingProcessor(CPlugin* pro);
+	DataChangeTypes EndTick(int rate);
+	void Flush();
+
+private:
+	void oscPacketEncoded(const char* data, int size, int numMessages) override;
+	bool PopSetCommand(CPlugin* pro, DataChangeTypes changeType, DataChangeTypes& paramSetsSent);
+	bool SendPollRequests();
+	void UpdatePollStatistics(int numRequired, int numSent);
+
+	/**
+	 * IP Address of the DS100. Empty if this entry of the device table is unused.
+	 */
+	String					m_ipAddress;
+
+	/**
+	 * m_ipAddress as an IPv4 address in host byte order, or 0 if unused or if the host name could not be resolved. 
+	 * Allows the receive thread to match senders without locking, see HasAddress().
+	 */
+	std::atomic<uint32>		m_rxAddress;
+
+	/**
+	 * True if m_ipAddress is not empty. Readable from the receive thread, see CController::GetOnlyUsedDevice().
+	 */
+	std::atomic<bool>		m_used;
+
+	/**
+	 * Latest values received from this DS100, until they are applied during the next timer tick.
+	 */
+	CSourceStateTable		m_rxState;
+
+	/**
+	 * Set by the receive thread whenever a valid response arrives, and taken during the next timer tick.
+	 */
+	std::atomic<bool>		m_responseReceived;
+
+	/**
+	 * Thread which owns the UDP socket and sends the encoded OSC packets out to the DS100.
+	 * Only running while connected, see Connect() and Disconnect().
+	 */
+	COscSendThread			m_oscSendThread;
+
+	/**
+	 * Encodes all messages generated for this device during one timer tick into OSC bundles which do not exceed 
+	 * the configured MTU, see SetMtu(). Finished packets are passed on to oscPacketEncoded().
+	 */
+	COscEncoder				m_txEncoder;
+
+	/**
+	 * Request budget towards the DS100, in OSC messages per second. See SetPollBudget().
+	 */
+	std::atomic<int>		m_pollBudget;
+
+	/**
+	 * Token bucket enforcing m_pollBudget: tokens are added at every timer tick according to the elapsed time, 
+	 * each SET command spends one if available, and each GET command requires one.
+	 */
+	double					m_pollTokens;
+
+	/**
+	 * Plug-ins bound to this device which are due for GET commands during the current timer tick. 
+	 * Kept as a member so that its storage is reused from tick to tick.
+	 */
+	Array<CPlugin*>			m_pollingProcessors;
+
+	/**
+	 * Round-robin position: the request which could not be sent anymore during the last timer tick,
+	 * identified by the Plug-in's SourceId, its address (only for comparison) and the OscCommand.
+	 */
+	SourceId				m_pollCursorSourceId;
+	const CPlugin*			m_pollCursorProcessor;
+	int						m_pollCursorCommand;
+
+	/**
+	 * Number of GET commands which were due, and which were actually sent, during the current statistics window.
+	 */
+	int						m_pollDemandCount;
+	int						m_pollServedCount;
+
+	/**
+	 * Number of timer ticks and start time of the current statistics window.
+	 */
+	int						m_pollWindowTicks;
+	double					m_pollWindowStart;
+
+	/**
+	 * Effective interval at which each polled parameter is refreshed, in milliseconds. See GetPollRefreshInterval().
+	 */
+	std::atomic<int>		m_pollRefreshInterval;
+
+	/**
+	 * True if a SET command was sent during the current timer tick, so that a response can be expected.
+	 */
+	bool					m_setCommandsSent;
+
+	/**
+	 * Number of UDP datagrams (OSC bundles or single messages) and number of OSC messages sent 
+	 * out during the current timer tick.
+	 */
+	int						m_txPacketCount;
+	int						m_txMessageCount;
+
+	/**
+	 * Number of UDP datagrams and number of OSC messages sent out during the last completed timer tick.
+	 */
+	std::atomic<int>		m_txPacketsPerTick;
+	std::atomic<int>		m_txMessagesPerTick;
+
+	/**
+	 * Number of timer intervals since the last successful OSC message was received.
+	 */
+	std::atomic<int>		m_heartBeatsRx;
+
+	/**
+	 * Number of timer intervals since the last OSC message was sent out.
+	 */
+	int						m_heartBeatsTx;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CDevice)
+};
+
+
+} // namespace dbaudio
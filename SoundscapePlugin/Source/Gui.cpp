@@ -76,6 +76,8 @@ Colour CDbStyle::GetDbColor(DbColor color)
 		return Colour(140, 180, 90);
 	case ButtonBlueColor:
 		return Colour(27, 120, 163);
+	case WarningColor:
+		return Colour(200, 80, 65);
 	default:
 		break;
 	}
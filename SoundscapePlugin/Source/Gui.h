@@ -64,6 +64,7 @@ public:
 		HighlightColor,		// 115 140 155 - Highlighted text
 		FaderGreenColor,	// 140 180 90 - Green sliders
 		ButtonBlueColor,	// 28 122 166 - Button Blue
+		WarningColor,		// 200 80 65 - Conflicting settings
 	};
 
 	CDbStyle() {};
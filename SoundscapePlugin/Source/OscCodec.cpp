@@ -0,0 +1,762 @@
+/*
+===============================================================================
+
+Copyright (C) 2019 d&b audiotechnik GmbH & Co. KG. All Rights Reserved.
+
+This file is part of the Soundscape VST, AU, and AAX Plug-in.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY d&b audiotechnik GmbH & Co. KG "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+===============================================================================
+*/
+
+
+
+#include "OscCodec.h"
+
+
+namespace dbaudio
+{
+
+
+/**
+ * Pre-defined OSC command strings
+ */
+static const String kOscCommandString_source_position_xy("/dbaudio1/coordinatemapping/source_position_xy/%d/%d");
+static const String kOscCommandString_reverbsendgain("/dbaudio1/matrixinput/reverbsendgain/%d");
+static const String kOscCommandString_source_spread("/dbaudio1/positioning/source_spread/%d");
+static const String kOscCommandString_source_delaymode("/dbaudio1/positioning/source_delaymode/%d");
+
+static constexpr int OSC_BUNDLE_HEADER_SIZE = 16;	//< "#bundle" string (8 bytes) plus time tag (8 bytes)
+static constexpr int OSC_BUNDLE_ELEMENT_PREFIX = 4;	//< Each bundle element is preceded by its size as int32
+static constexpr int OSC_BUNDLE_MAX_DEPTH = 4;		//< Nesting depth beyond which received bundles are rejected
+
+
+/**
+ * Helper to round a size up to the next multiple of 4 bytes, as required by the OSC specification
+ * for address patterns, type tag strings and arguments.
+ * @param size	Unpadded size in bytes.
+ * @return	Padded size in bytes.
+ */
+static int GetOSCPaddedSize(int size)
+{
+	return ((size + 3) & ~3);
+}
+
+
+/**
+ * Helper to read a 32-bit value in big-endian byte order.
+ * @param data	Pointer to the value. At least 4 bytes must be available.
+ * @return	The value.
+ */
+static juce::uint32 ReadOSCInt32(const char* data)
+{
+	const juce::uint8* bytes = reinterpret_cast<const juce::uint8*>(data);
+	return ((static_cast<juce::uint32>(bytes[0]) << 24) |
+			(static_cast<juce::uint32>(bytes[1]) << 16) |
+			(static_cast<juce::uint32>(bytes[2]) << 8) |
+			static_cast<juce::uint32>(bytes[3]));
+}
+
+
+/**
+ * Node of the trie of known address patterns, see kOscAddressTrie.
+ */
+struct OscAddressNode
+{
+	const char*		segment;		//< Path segment, without delimiters.
+	int				length;			//< Length of segment.
+	int				firstChild;		//< Index of the first child node, whose siblings follow directly after it.
+	int				numChildren;	//< Number of child nodes. Leaf nodes have none.
+	OscResponse		response;		//< Kind of message identified by a leaf node.
+	OscCommand		command;		//< Command identified by an OscRsp_Command leaf node.
+};
+
+
+/**
+ * Trie of the address patterns received from the DS100, one node per path segment. 
+ * Node 0 is the root, i.e. the empty segment before the leading "/".
+ */
+static constexpr OscAddressNode kOscAddressTrie[] =
+{
+	/* 0 */ { "",						0,	1, 2,	OscRsp_Unknown,	OscCmd_MaxIndex },
+	/* 1 */ { "pong",					4,	0, 0,	OscRsp_Pong,	OscCmd_MaxIndex },
+	/* 2 */ { "dbaudio1",				8,	3, 3,	OscRsp_Unknown,	OscCmd_MaxIndex },
+	/* 3 */ { "coordinatemapping",		17,	6, 1,	OscRsp_Unknown,	OscCmd_MaxIndex },
+	/* 4 */ { "matrixinput",			11,	7, 1,	OscRsp_Unknown,	OscCmd_MaxIndex },
+	/* 5 */ { "positioning",			11,	8, 2,	OscRsp_Unknown,	OscCmd_MaxIndex },
+	/* 6 */ { "source_position_xy",		18,	0, 0,	OscRsp_Command,	OscCmd_SourcePositionXY },
+	/* 7 */ { "reverbsendgain",			14,	0, 0,	OscRsp_Command,	OscCmd_ReverbSendGain },
+	/* 8 */ { "source_spread",			13,	0, 0,	OscRsp_Command,	OscCmd_SourceSpread },
+	/* 9 */ { "source_delaymode",		16,	0, 0,	OscRsp_Command,	OscCmd_SourceDelayMode },
+};
+
+
+/*
+===============================================================================
+ Class COscAddressParser
+===============================================================================
+*/
+
+/**
+ * Identify a received address pattern. Replies to dbaudio1 commands must be followed by exactly 
+ * the IDs which the command takes: "/<mappingId>/<sourceId>" for OscCmd_SourcePositionXY, 
+ * "/<sourceId>" for all others. Anything following "/pong" is ignored.
+ * @param address	Null-terminated address pattern.
+ * @return	The identified message, with response OscRsp_Unknown if the address is not recognized.
+ */
+COscAddressParser::Address COscAddressParser::Parse(const char* address)
+{
+	Address result = { OscRsp_Unknown, OscCmd_MaxIndex, 0, 0 };
+
+	if (address == nullptr)
+		return result;
+
+	const char* pos = address;
+	const OscAddressNode* node = &kOscAddressTrie[0];
+
+	// Walk down the trie, one path segment at a time, until a leaf is reached.
+	while (node->numChildren > 0)
+	{
+		if (*pos != '/')
+			return result;
+		++pos;
+
+		const char* segment = pos;
+		while ((*pos != '/') && (*pos != 0))
+			++pos;
+		int length = static_cast<int>(pos - segment);
+
+		const OscAddressNode* child = nullptr;
+		for (int i = 0; (i < node->numChildren) && (child == nullptr); ++i)
+		{
+			const OscAddressNode& candidate = kOscAddressTrie[node->firstChild + i];
+			if ((candidate.length == length) && (std::memcmp(candidate.segment, segment, static_cast<size_t>(length)) == 0))
+				child = &candidate;
+		}
+
+		if (child == nullptr)
+			return result;
+		node = child;
+	}
+
+	if (node->response == OscRsp_Pong)
+	{
+		result.response = OscRsp_Pong;
+		return result;
+	}
+
+	jassert(node->response == OscRsp_Command);
+	int mappingId = 0;
+	int sourceId = 0;
+	if ((node->command == OscCmd_SourcePositionXY) && !ParseId(pos, MAPPING_ID_MIN, MAPPING_ID_MAX, mappingId))
+		return result;
+	if (!ParseId(pos, SOURCE_ID_MIN, SOURCE_ID_MAX, sourceId) || (*pos != 0))
+		return result;
+
+	result.response = OscRsp_Command;
+	result.command = node->command;
+	result.mappingId = mappingId;
+	result.sourceId = static_cast<SourceId>(sourceId);
+	return result;
+}
+
+/**
+ * Parse a "/"-prefixed decimal ID segment, and advance past it.
+ * @param pos		Current position within the address pattern. Advanced past the segment on success.
+ * @param minValue	Smallest valid ID.
+ * @param maxValue	Largest valid ID.
+ * @param result	The parsed ID.
+ * @return	True if the segment contained only digits, and the ID is within the given range.
+ */
+bool COscAddressParser::ParseId(const char*& pos, int minValue, int maxValue, int& result)
+{
+	const char* cursor = pos;
+	if (*cursor != '/')
+		return false;
+	++cursor;
+
+	int value = 0;
+	const char* digits = cursor;
+	while ((*cursor >= '0') && (*cursor <= '9'))
+	{
+		value = (value * 10) + (*cursor - '0');
+		if (value > maxValue)
+			return false;
+		++cursor;
+	}
+
+	if ((cursor == digits) || (value < minValue) || ((*cursor != '/') && (*cursor != 0)))
+		return false;
+
+	pos = cursor;
+	result = value;
+	return true;
+}
+
+
+/*
+===============================================================================
+ Class COscAddressCache
+===============================================================================
+*/
+
+/**
+ * Object constructor.
+ * The cache is empty until Update() is called for the first time.
+ */
+COscAddressCache::COscAddressCache()
+{
+	for (int cmd = 0; cmd < OscCmd_MaxIndex; cmd++)
+	{
+		std::memset(m_addresses[cmd], 0, MAX_ADDRESS_SIZE);
+		m_addressSizes[cmd] = 0;
+	}
+}
+
+/**
+ * Object destructor.
+ */
+COscAddressCache::~COscAddressCache()
+{
+}
+
+/**
+ * Re-encode all address patterns for the given coordinate mapping and SourceID.
+ * @param mappingId		Coordinate mapping used for the X/Y position command.
+ * @param sourceId		SourceID, or matrix input number.
+ */
+void COscAddressCache::Update(int mappingId, SourceId sourceId)
+{
+	for (int cmd = 0; cmd < OscCmd_MaxIndex; cmd++)
+	{
+		String address;
+		switch (cmd)
+		{
+			case OscCmd_SourcePositionXY:
+				address = String::formatted(kOscCommandString_source_position_xy, mappingId, sourceId);
+				break;
+			case OscCmd_ReverbSendGain:
+				address = String::formatted(kOscCommandString_reverbsendgain, sourceId);
+				break;
+			case OscCmd_SourceSpread:
+				address = String::formatted(kOscCommandString_source_spread, sourceId);
+				break;
+			case OscCmd_SourceDelayMode:
+				address = String::formatted(kOscCommandString_source_delaymode, sourceId);
+				break;
+			default:
+				jassertfalse;
+				break;
+		}
+
+		// Null-terminate and pad to the next multiple of 4 bytes.
+		int length = jmin(static_cast<int>(address.getNumBytesAsUTF8()), MAX_ADDRESS_SIZE - 1);
+		std::memset(m_addresses[cmd], 0, MAX_ADDRESS_SIZE);
+		std::memcpy(m_addresses[cmd], address.toRawUTF8(), static_cast<size_t>(length));
+		m_addressSizes[cmd] = GetOSCPaddedSize(length + 1);
+	}
+}
+
+/**
+ * Get the encoded address pattern of the given command.
+ * @param command	The desired dbaudio1 command.
+ * @return	Pointer to the encoded address pattern. It is GetAddressSize() bytes long.
+ */
+const char* COscAddressCache::GetAddress(OscCommand command) const
+{
+	jassert((command >= 0) && (command < OscCmd_MaxIndex));
+	return m_addresses[command];
+}
+
+/**
+ * Get the encoded size of the given command's address pattern.
+ * @param command	The desired dbaudio1 command.
+ * @return	Size in bytes, including null-termination and padding.
+ */
+int COscAddressCache::GetAddressSize(OscCommand command) const
+{
+	jassert((command >= 0) && (command < OscCmd_MaxIndex));
+	return m_addressSizes[command];
+}
+
+
+/*
+===============================================================================
+ Class COscEncoder
+===============================================================================
+*/
+
+/**
+ * Object constructor. The packet buffer is allocated here once, and reused afterwards.
+ * @param listener		Receiver of the encoded packets.
+ * @param maxPacketSize	Maximum size of the encoded packets, in bytes.
+ */
+COscEncoder::COscEncoder(Listener* listener, int maxPacketSize)
+	: m_listener(listener),
+	m_buffer(static_cast<size_t>(MAX_PACKET_SIZE)),
+	m_size(0),
+	m_numMessages(0)
+{
+	SetMaxPacketSize(maxPacketSize);
+}
+
+/**
+ * Object destructor.
+ */
+COscEncoder::~COscEncoder()
+{
+}
+
+/**
+ * Getter for the maximum packet size.
+ * @return	Maximum size of the encoded packets, in bytes.
+ */
+int COscEncoder::GetMaxPacketSize() const
+{
+	return m_maxPacketSize;
+}
+
+/**
+ * Setter for the maximum packet size. Takes effect starting with the next message added.
+ * @param maxPacketSize	Maximum size of the encoded packets, in bytes.
+ */
+void COscEncoder::SetMaxPacketSize(int maxPacketSize)
+{
+	m_maxPacketSize = jmin(MAX_PACKET_SIZE, jmax(OSC_BUNDLE_HEADER_SIZE, maxPacketSize));
+}
+
+/**
+ * Add a message without arguments, i.e. a GET command or a ping.
+ * @param address		Encoded address pattern, null-terminated and padded to a multiple of 4 bytes.
+ * @param addressSize	Size of the encoded address pattern, in bytes.
+ */
+void COscEncoder::AddMessage(const char* address, int addressSize)
+{
+	BeginMessage(address, addressSize, ",", 0);
+}
+
+/**
+ * Add a message with one int32 argument.
+ * @param address		Encoded address pattern, null-terminated and padded to a multiple of 4 bytes.
+ * @param addressSize	Size of the encoded address pattern, in bytes.
+ * @param value			Argument value.
+ */
+void COscEncoder::AddMessage(const char* address, int addressSize, int value)
+{
+	BeginMessage(address, addressSize, ",i", 1);
+	WriteInt32(static_cast<juce::uint32>(value));
+}
+
+/**
+ * Add a message with one float32 argument.
+ * @param address		Encoded address pattern, null-terminated and padded to a multiple of 4 bytes.
+ * @param addressSize	Size of the encoded address pattern, in bytes.
+ * @param value			Argument value.
+ */
+void COscEncoder::AddMessage(const char* address, int addressSize, float value)
+{
+	BeginMessage(address, addressSize, ",f", 1);
+	WriteFloat32(value);
+}
+
+/**
+ * Add a message with two float32 arguments.
+ * @param address		Encoded address pattern, null-terminated and padded to a multiple of 4 bytes.
+ * @param addressSize	Size of the encoded address pattern, in bytes.
+ * @param value1		First argument value.
+ * @param value2		Second argument value.
+ */
+void COscEncoder::AddMessage(const char* address, int addressSize, float value1, float value2)
+{
+	BeginMessage(address, addressSize, ",ff", 2);
+	WriteFloat32(value1);
+	WriteFloat32(value2);
+}
+
+/**
+ * Hand the messages collected so far to the listener, and start over with an empty buffer.
+ */
+void COscEncoder::Flush()
+{
+	if (m_listener && (m_numMessages == 1))
+	{
+		// Skip the bundle header and the element size.
+		int offset = OSC_BUNDLE_HEADER_SIZE + OSC_BUNDLE_ELEMENT_PREFIX;
+		m_listener->oscPacketEncoded(m_buffer + offset, m_size - offset, 1);
+	}
+	else if (m_listener && (m_numMessages > 1))
+	{
+		m_listener->oscPacketEncoded(m_buffer, m_size, m_numMessages);
+	}
+
+	m_size = 0;
+	m_numMessages = 0;
+}
+
+/**
+ * Write everything of a message except for the argument values. If the whole message would not fit 
+ * into the current packet anymore, the packet is flushed first.
+ * @param address		Encoded address pattern, null-terminated and padded to a multiple of 4 bytes.
+ * @param addressSize	Size of the encoded address pattern, in bytes.
+ * @param typeTags		Type tag string, starting with ','.
+ * @param numArguments	Number of arguments, which must be written right after this call.
+ */
+void COscEncoder::BeginMessage(const char* address, int addressSize, const char* typeTags, int numArguments)
+{
+	int typeTagSize = GetOSCPaddedSize(numArguments + 2);
+	int messageSize = addressSize + typeTagSize + (4 * numArguments);
+
+	if ((m_numMessages > 0) && ((m_size + OSC_BUNDLE_ELEMENT_PREFIX + messageSize) > m_maxPacketSize))
+		Flush();
+
+	// A single dbaudio1 message is always much smaller than the smallest allowed packet.
+	jassert((OSC_BUNDLE_HEADER_SIZE + OSC_BUNDLE_ELEMENT_PREFIX + messageSize) <= MAX_PACKET_SIZE);
+
+	if (m_numMessages == 0)
+	{
+		// Bundle header, with the time tag 1 meaning "immediately".
+		std::memcpy(m_buffer, "#bundle", 8);
+		m_size = 8;
+		WriteInt32(0);
+		WriteInt32(1);
+	}
+
+	WriteInt32(static_cast<juce::uint32>(messageSize));
+
+	std::memcpy(m_buffer + m_size, address, static_cast<size_t>(addressSize));
+	m_size += addressSize;
+
+	std::memset(m_buffer + m_size, 0, static_cast<size_t>(typeTagSize));
+	std::memcpy(m_buffer + m_size, typeTags, static_cast<size_t>(numArguments + 1));
+	m_size += typeTagSize;
+
+	m_numMessages++;
+}
+
+/**
+ * Append a 32-bit value in big-endian byte order.
+ * @param value	The value to write.
+ */
+void COscEncoder::WriteInt32(juce::uint32 value)
+{
+	char* dest = m_buffer + m_size;
+	dest[0] = static_cast<char>((value >> 24) & 0xFF);
+	dest[1] = static_cast<char>((value >> 16) & 0xFF);
+	dest[2] = static_cast<char>((value >> 8) & 0xFF);
+	dest[3] = static_cast<char>(value & 0xFF);
+	m_size += 4;
+}
+
+/**
+ * Append a 32-bit float in big-endian byte order.
+ * @param value	The value to write.
+ */
+void COscEncoder::WriteFloat32(float value)
+{
+	juce::uint32 bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	WriteInt32(bits);
+}
+
+
+/*
+===============================================================================
+ Class COscMessageView
+===============================================================================
+*/
+
+/**
+ * Object constructor. The view is empty until it is filled in by COscDecoder.
+ */
+COscMessageView::COscMessageView()
+	: m_address(""),
+	m_typeTags(""),
+	m_numArguments(0)
+{
+}
+
+/**
+ * Object destructor.
+ */
+COscMessageView::~COscMessageView()
+{
+}
+
+/**
+ * Getter for the address pattern.
+ * @return	Pointer to the null-terminated address pattern, within the received datagram.
+ */
+const char* COscMessageView::GetAddress() const
+{
+	return m_address;
+}
+
+/**
+ * Getter for the number of arguments.
+ * @return	Number of arguments of the message.
+ */
+int COscMessageView::GetNumArguments() const
+{
+	return m_numArguments;
+}
+
+/**
+ * Check the type of an argument.
+ * @param index	Index of the argument.
+ * @return	True if the argument exists and is an int32.
+ */
+bool COscMessageView::IsInt32(int index) const
+{
+	return ((index >= 0) && (index < m_numArguments) && (m_typeTags[index] == 'i'));
+}
+
+/**
+ * Check the type of an argument.
+ * @param index	Index of the argument.
+ * @return	True if the argument exists and is a float32.
+ */
+bool COscMessageView::IsFloat32(int index) const
+{
+	return ((index >= 0) && (index < m_numArguments) && (m_typeTags[index] == 'f'));
+}
+
+/**
+ * Check the type of an argument.
+ * @param index	Index of the argument.
+ * @return	True if the argument exists and is a string.
+ */
+bool COscMessageView::IsString(int index) const
+{
+	return ((index >= 0) && (index < m_numArguments) && (m_typeTags[index] == 's'));
+}
+
+/**
+ * Get the value of an int32 argument.
+ * @param index	Index of the argument, see IsInt32().
+ * @return	The argument's value, or 0 if it is not an int32.
+ */
+juce::int32 COscMessageView::GetInt32(int index) const
+{
+	jassert(IsInt32(index));
+	if (!IsInt32(index))
+		return 0;
+
+	return static_cast<juce::int32>(ReadOSCInt32(m_arguments[index]));
+}
+
+/**
+ * Get the value of a float32 argument.
+ * @param index	Index of the argument, see IsFloat32().
+ * @return	The argument's value, or 0.0f if it is not a float32.
+ */
+float COscMessageView::GetFloat32(int index) const
+{
+	jassert(IsFloat32(index));
+	if (!IsFloat32(index))
+		return 0.0f;
+
+	juce::uint32 bits = ReadOSCInt32(m_arguments[index]);
+	float value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+/**
+ * Get the value of a string argument.
+ * @param index	Index of the argument, see IsString().
+ * @return	Pointer to the null-terminated string within the received datagram, or an empty string if it is not a string.
+ */
+const char* COscMessageView::GetString(int index) const
+{
+	jassert(IsString(index));
+	if (!IsString(index))
+		return "";
+
+	return m_arguments[index];
+}
+
+
+/*
+===============================================================================
+ Class COscDecoder
+===============================================================================
+*/
+
+/**
+ * Parse a received datagram, and pass every OSC message it contains on to the listener.
+ * Bundles are unpacked recursively, their time tags are ignored.
+ * @param data		Pointer to the received datagram.
+ * @param size		Size of the received datagram, in bytes.
+ * @param listener	Receiver of the decoded messages.
+ * @return	True if the whole datagram could be parsed.
+ */
+bool COscDecoder::DecodePacket(const char* data, int size, Listener* listener)
+{
+	struct BundleLevel
+	{
+		const char* data;
+		int size;
+	};
+
+	// Bundles are unpacked iteratively, using a small fixed stack of the enclosing bundles.
+	BundleLevel levels[OSC_BUNDLE_MAX_DEPTH];
+	int depth = 0;
+	bool ok = true;
+
+	if ((size <= 0) || ((size % 4) != 0))
+		return false;
+
+	if ((size >= OSC_BUNDLE_HEADER_SIZE) && (std::memcmp(data, "#bundle", 8) == 0))
+		levels[depth++] = { data + OSC_BUNDLE_HEADER_SIZE, size - OSC_BUNDLE_HEADER_SIZE };
+	else
+		return DecodeMessage(data, size, listener);
+
+	while (depth > 0)
+	{
+		BundleLevel& level = levels[depth - 1];
+		if (level.size == 0)
+		{
+			depth--;
+			continue;
+		}
+
+		if (level.size < OSC_BUNDLE_ELEMENT_PREFIX)
+			return false;
+
+		int elementSize = static_cast<int>(ReadOSCInt32(level.data));
+		const char* element = level.data + OSC_BUNDLE_ELEMENT_PREFIX;
+		if ((elementSize <= 0) || ((elementSize % 4) != 0) || (elementSize > (level.size - OSC_BUNDLE_ELEMENT_PREFIX)))
+			return false;
+
+		level.data += OSC_BUNDLE_ELEMENT_PREFIX + elementSize;
+		level.size -= OSC_BUNDLE_ELEMENT_PREFIX + elementSize;
+
+		if ((elementSize >= OSC_BUNDLE_HEADER_SIZE) && (std::memcmp(element, "#bundle", 8) == 0))
+		{
+			if (depth == OSC_BUNDLE_MAX_DEPTH)
+				return false;
+			levels[depth++] = { element + OSC_BUNDLE_HEADER_SIZE, elementSize - OSC_BUNDLE_HEADER_SIZE };
+		}
+		else if (!DecodeMessage(element, elementSize, listener))
+		{
+			// Skip the malformed message, but carry on with the rest of the bundle.
+			ok = false;
+		}
+	}
+
+	return ok;
+}
+
+/**
+ * Parse a single OSC message in place, and pass a view of it on to the listener.
+ * @param data		Pointer to the encoded message.
+ * @param size		Size of the encoded message, in bytes.
+ * @param listener	Receiver of the decoded message.
+ * @return	True if the message could be parsed.
+ */
+bool COscDecoder::DecodeMessage(const char* data, int size, Listener* listener)
+{
+	COscMessageView message;
+
+	int pos = ReadString(data, size);
+	if ((pos == 0) || (data[0] != '/'))
+		return false;
+	message.m_address = data;
+
+	// Type tag string. Very old OSC implementations omit it, in which case the message has no arguments.
+	if (pos < size)
+	{
+		int typeTagSize = ReadString(data + pos, size - pos);
+		if ((typeTagSize == 0) || (data[pos] != ','))
+			return false;
+		message.m_typeTags = data + pos + 1;
+		pos += typeTagSize;
+	}
+
+	for (int i = 0; message.m_typeTags[i] != 0; ++i)
+	{
+		if (i == COscMessageView::MAX_ARGUMENTS)
+			return false;
+
+		switch (message.m_typeTags[i])
+		{
+			case 'i':
+			case 'f':
+				if ((size - pos) < 4)
+					return false;
+				message.m_arguments[i] = data + pos;
+				pos += 4;
+				break;
+
+			case 's':
+			{
+				int valueSize = ReadString(data + pos, size - pos);
+				if (valueSize == 0)
+					return false;
+				message.m_arguments[i] = data + pos;
+				pos += valueSize;
+			}
+			break;
+
+			default:
+				// Not used by the dbaudio1 protocol.
+				return false;
+		}
+
+		message.m_numArguments = i + 1;
+	}
+
+	if (listener)
+		listener->oscMessageDecoded(message);
+
+	return true;
+}
+
+/**
+ * Check a null-terminated string, which is padded to a multiple of 4 bytes.
+ * @param data		Pointer to the start of the string.
+ * @param size		Number of bytes available.
+ * @return	Number of bytes used by the string including padding, or 0 if it is not terminated within size.
+ */
+int COscDecoder::ReadString(const char* data, int size)
+{
+	if (size <= 0)
+		return 0;
+
+	const void* terminator = std::memchr(data, 0, static_cast<size_t>(size));
+	if (terminator == nullptr)
+		return 0;
+
+	int length = static_cast<int>(static_cast<const char*>(terminator) - data);
+	int paddedSize = GetOSCPaddedSize(length + 1);
+	if (paddedSize > size)
+		return 0;
+
+	return paddedSize;
+}
+
+
+} // namespace dbaudio
@@ -0,0 +1,289 @@
+/*
+===============================================================================
+
+Copyright (C) 2019 d&b audiotechnik GmbH & Co. KG. All Rights Reserved.
+
+This file is part of the Soundscape VST, AU, and AAX Plug-in.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY d&b audiotechnik GmbH & Co. KG "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+===============================================================================
+*/
+
+
+
+#pragma once
+
+#include "Common.h"
+
+
+namespace dbaudio
+{
+
+
+/**
+ * dbaudio1 commands which are sent to the DS100 for each Plug-in instance.
+ */
+enum OscCommand
+{
+	OscCmd_SourcePositionXY = 0,	//< X/Y coordinates, relative to a coordinate mapping.
+	OscCmd_ReverbSendGain,			//< En-Space gain of a matrix input.
+	OscCmd_SourceSpread,			//< En-Scene spread factor.
+	OscCmd_SourceDelayMode,			//< En-Scene delay mode (Off/Tight/Full).
+	OscCmd_MaxIndex
+};
+
+
+/**
+ * Kinds of OSC messages which are received from the DS100.
+ */
+enum OscResponse
+{
+	OscRsp_Unknown = 0,	//< Address pattern not recognized, or IDs out of range.
+	OscRsp_Pong,		//< Reply to a ping.
+	OscRsp_Command		//< Reply to a dbaudio1 command, see enum OscCommand.
+};
+
+
+/**
+ * Class COscAddressParser identifies the dbaudio1 address patterns received from the DS100. 
+ * The address is split into its "/"-separated segments in a single pass, and the segments are looked up 
+ * in a small static trie of the known dbaudio1 paths. The trailing segments are parsed as MappingID 
+ * and SourceID. Nothing is allocated, so Parse() may be called on the receive thread.
+ */
+class COscAddressParser
+{
+public:
+	/**
+	 * Result of Parse(). The IDs are only valid for OscRsp_Command, and are within their value ranges.
+	 */
+	struct Address
+	{
+		OscResponse		response;	//< What kind of message this is.
+		OscCommand		command;	//< Which dbaudio1 command the message replies to.
+		int				mappingId;	//< Coordinate mapping, only relevant for OscCmd_SourcePositionXY.
+		SourceId		sourceId;	//< SourceID, or matrix input number.
+	};
+
+	static Address Parse(const char* address);
+
+private:
+	static bool ParseId(const char*& pos, int minValue, int maxValue, int& result);
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(COscAddressParser)
+};
+
+
+/**
+ * Class COscAddressCache holds the OSC address patterns of all dbaudio1 commands for one Plug-in instance,
+ * already encoded as they appear on the wire: null-terminated and padded to a multiple of 4 bytes.
+ * Since the addresses only depend on the SourceID and MappingID, they only need to be rebuilt 
+ * when either of these change, and can otherwise be copied directly into outgoing packets.
+ */
+class COscAddressCache
+{
+public:
+	COscAddressCache();
+	~COscAddressCache();
+
+	void Update(int mappingId, SourceId sourceId);
+	const char* GetAddress(OscCommand command) const;
+	int GetAddressSize(OscCommand command) const;
+
+private:
+	/**
+	 * Maximum encoded size of a single address pattern. The longest address, 
+	 * "/dbaudio1/coordinatemapping/source_position_xy/m/sss", needs 56 bytes.
+	 */
+	static constexpr int MAX_ADDRESS_SIZE = 64;
+
+	/**
+	 * Encoded address patterns, one for each OscCommand.
+	 */
+	char	m_addresses[OscCmd_MaxIndex][MAX_ADDRESS_SIZE];
+
+	/**
+	 * Encoded size of each address pattern, including null-termination and padding.
+	 */
+	int		m_addressSizes[OscCmd_MaxIndex];
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(COscAddressCache)
+};
+
+
+/**
+ * Class COscEncoder writes OSC messages with pre-encoded address patterns directly into a fixed buffer,
+ * which is allocated once and reused for every packet. Consecutive messages are collected into an OSC bundle 
+ * until the next message would exceed the maximum packet size, at which point the packet is handed 
+ * to the Listener and the buffer is reused for the next one.
+ * Only the argument types used by the dbaudio1 commands (int32 and float32) are supported.
+ */
+class COscEncoder
+{
+public:
+	/**
+	 * Receives the encoded packets. A packet containing only one message is passed on 
+	 * as a plain OSC message instead of a bundle.
+	 */
+	class Listener
+	{
+	public:
+		virtual ~Listener() = default;
+		virtual void oscPacketEncoded(const char* data, int size, int numMessages) = 0;
+	};
+
+	/**
+	 * Largest possible UDP payload over IPv4, in bytes.
+	 */
+	static constexpr int MAX_PACKET_SIZE = 65507;
+
+	COscEncoder(Listener* listener, int maxPacketSize);
+	~COscEncoder();
+
+	int GetMaxPacketSize() const;
+	void SetMaxPacketSize(int maxPacketSize);
+
+	void AddMessage(const char* address, int addressSize);
+	void AddMessage(const char* address, int addressSize, int value);
+	void AddMessage(const char* address, int addressSize, float value);
+	void AddMessage(const char* address, int addressSize, float value1, float value2);
+	void Flush();
+
+private:
+	void BeginMessage(const char* address, int addressSize, const char* typeTags, int numArguments);
+	void WriteInt32(juce::uint32 value);
+	void WriteFloat32(float value);
+
+	/**
+	 * Receiver of the encoded packets.
+	 */
+	Listener*			m_listener;
+
+	/**
+	 * Packet buffer, MAX_PACKET_SIZE bytes long.
+	 */
+	HeapBlock<char>		m_buffer;
+
+	/**
+	 * Packets handed to the listener will not be larger than this, in bytes.
+	 */
+	int					m_maxPacketSize;
+
+	/**
+	 * Number of bytes currently used in m_buffer.
+	 */
+	int					m_size;
+
+	/**
+	 * Number of messages currently contained in m_buffer.
+	 */
+	int					m_numMessages;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(COscEncoder)
+};
+
+
+/**
+ * Class COscMessageView gives typed access to a received OSC message directly within the datagram buffer, 
+ * without copying or allocating anything. It is only valid during the COscDecoder callback it was passed to.
+ * Supported argument types are int32 ('i'), float32 ('f') and string ('s').
+ */
+class COscMessageView
+{
+public:
+	/**
+	 * Messages with more arguments are rejected by COscDecoder. dbaudio1 replies have at most two.
+	 */
+	static constexpr int MAX_ARGUMENTS = 8;
+
+	COscMessageView();
+	~COscMessageView();
+
+	const char* GetAddress() const;
+	int GetNumArguments() const;
+	bool IsInt32(int index) const;
+	bool IsFloat32(int index) const;
+	bool IsString(int index) const;
+	juce::int32 GetInt32(int index) const;
+	float GetFloat32(int index) const;
+	const char* GetString(int index) const;
+
+private:
+	friend class COscDecoder;
+
+	/**
+	 * Null-terminated address pattern.
+	 */
+	const char*		m_address;
+
+	/**
+	 * Type tag of each argument, without the leading ','.
+	 */
+	const char*		m_typeTags;
+
+	/**
+	 * Start of each argument's encoded value.
+	 */
+	const char*		m_arguments[MAX_ARGUMENTS];
+
+	/**
+	 * Number of valid entries in m_arguments.
+	 */
+	int				m_numArguments;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(COscMessageView)
+};
+
+
+/**
+ * Class COscDecoder parses received UDP datagrams, which contain either a single OSC message 
+ * or an OSC bundle, in place, and passes a COscMessageView of each contained message on to the Listener.
+ * Only the argument types used by the dbaudio1 responses (int32, float32 and string) are supported.
+ * Messages with any other argument types, and malformed datagrams, are skipped.
+ */
+class COscDecoder
+{
+public:
+	/**
+	 * Receives the decoded messages, on the thread which called DecodePacket().
+	 */
+	class Listener
+	{
+	public:
+		virtual ~Listener() = default;
+		virtual void oscMessageDecoded(const COscMessageView& message) = 0;
+	};
+
+	static bool DecodePacket(const char* data, int size, Listener* listener);
+
+private:
+	static bool DecodeMessage(const char* data, int size, Listener* listener);
+	static int ReadString(const char* data, int size);
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(COscDecoder)
+};
+
+
+} // namespace dbaudio
@@ -0,0 +1,513 @@
+/*
+===============================================================================
+
+Copyright (C) 2019 d&b audiotechnik GmbH & Co. KG. All Rights Reserved.
+
+This file is part of the Soundscape VST, AU, and AAX Plug-in.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY d&b audiotechnik GmbH & Co. KG "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+===============================================================================
+*/
+
+
+
+#include "OscTransport.h"
+#include "OscCodec.h"
+
+#if JUCE_WINDOWS
+ #include <winsock2.h>
+ #include <ws2tcpip.h>
+#else
+ #include <sys/socket.h>
+ #include <netinet/in.h>
+#endif
+
+
+namespace dbaudio
+{
+
+
+static constexpr int TX_QUEUE_SIZE = 256 * 1024;	//< Size of the outbound packet queue, in bytes
+static constexpr int TX_STOP_TIMEOUT = 500;			//< Milliseconds to wait for the send thread to finish
+static constexpr int RX_STOP_TIMEOUT = 500;			//< Milliseconds to wait for the receive thread to finish
+static constexpr int RX_WAIT_TIMEOUT = 100;			//< Milliseconds after which the receive thread checks whether it should exit
+static constexpr int DEADLINE_TIMER_PERIOD = 1;		//< Resolution of CDeadlineTimer, in milliseconds
+static constexpr int DEADLINE_IDLE_TIMEOUT = 1000;	//< Milliseconds without any armed deadline after which CDeadlineTimer goes to sleep
+static constexpr int DEADLINE_STOP_TIMEOUT = 500;	//< Milliseconds to wait for the CDeadlineTimer thread to finish
+
+
+/*
+===============================================================================
+ Class COscSendThread
+===============================================================================
+*/
+
+/**
+ * Object constructor. Queue and send buffers are allocated here once, and reused afterwards.
+ */
+COscSendThread::COscSendThread()
+	: Thread("dbaudio OSC send"),
+	m_port(0),
+	m_queue(TX_QUEUE_SIZE),
+	m_queueBuffer(static_cast<size_t>(TX_QUEUE_SIZE)),
+	m_sendBuffer(static_cast<size_t>(COscEncoder::MAX_PACKET_SIZE)),
+	m_queuedPackets(0),
+	m_droppedPackets(0),
+	m_failedPackets(0)
+{
+}
+
+/**
+ * Object destructor.
+ */
+COscSendThread::~COscSendThread()
+{
+	Stop();
+}
+
+/**
+ * Open the socket on any free local port, and start the send thread.
+ * If the thread is already running, it is stopped first.
+ * @param ipAddress	IP address to which all packets will be sent.
+ * @param port		UDP port to which all packets will be sent.
+ * @return	True if the socket could be opened.
+ */
+bool COscSendThread::Start(const String& ipAddress, int port)
+{
+	Stop();
+
+	m_ipAddress = ipAddress;
+	m_port = port;
+
+	m_socket = std::make_unique<DatagramSocket>();
+	if (!m_socket->bindToPort(0))
+	{
+		m_socket.reset();
+		return false;
+	}
+
+	startThread();
+
+	return true;
+}
+
+/**
+ * Stop the send thread and close the socket. Any packets still in the queue are discarded.
+ */
+void COscSendThread::Stop()
+{
+	signalThreadShouldExit();
+	notify();
+	if (m_socket)
+		m_socket->shutdown();
+
+	stopThread(TX_STOP_TIMEOUT);
+	m_socket.reset();
+
+	m_queue.reset();
+	m_queuedPackets = 0;
+}
+
+/**
+ * Check whether the send thread is currently running.
+ * @return	True if packets will currently be accepted by EnqueuePacket().
+ */
+bool COscSendThread::IsRunning() const
+{
+	return isThreadRunning();
+}
+
+/**
+ * Copy an encoded packet into the queue, and wake up the send thread.
+ * If there is not enough free space in the queue, the packet is dropped.
+ * NOTE: Must not be called concurrently from more than one thread, see class description.
+ * @param data	Pointer to the encoded packet.
+ * @param size	Size of the encoded packet, in bytes.
+ * @return	True if the packet was queued.
+ */
+bool COscSendThread::EnqueuePacket(const void* data, int size)
+{
+	if (!IsRunning())
+		return false;
+
+	jassert((size > 0) && (size <= COscEncoder::MAX_PACKET_SIZE));
+	const int sizeWithHeader = static_cast<int>(sizeof(int)) + size;
+	if (m_queue.getFreeSpace() < sizeWithHeader)
+	{
+		m_droppedPackets++;
+		return false;
+	}
+
+	// Packet size, followed by the packet itself. Either may wrap around the end of the ring buffer.
+	int start1, size1, start2, size2;
+	m_queue.prepareToWrite(sizeWithHeader, start1, size1, start2, size2);
+	jassert((size1 + size2) == sizeWithHeader);
+	WriteToQueue(start1, &size, static_cast<int>(sizeof(int)));
+	WriteToQueue((start1 + static_cast<int>(sizeof(int))) % TX_QUEUE_SIZE, data, size);
+
+	m_queue.finishedWrite(sizeWithHeader);
+	m_queuedPackets++;
+
+	notify();
+
+	return true;
+}
+
+/**
+ * Number of packets currently waiting in the queue.
+ * @return	Queue depth, in packets.
+ */
+int COscSendThread::GetQueuedPackets() const
+{
+	return m_queuedPackets;
+}
+
+/**
+ * Number of bytes currently occupied in the queue, including the per-packet size headers.
+ * @return	Queue depth, in bytes.
+ */
+int COscSendThread::GetQueuedBytes() const
+{
+	return m_queue.getNumReady();
+}
+
+/**
+ * Number of packets which were dropped because the queue was full, since the object was created.
+ * @return	Number of dropped packets.
+ */
+int COscSendThread::GetDroppedPackets() const
+{
+	return m_droppedPackets;
+}
+
+/**
+ * Number of packets which could not be written to the socket, since the object was created.
+ * @return	Number of failed packets.
+ */
+int COscSendThread::GetFailedPackets() const
+{
+	return m_failedPackets;
+}
+
+/**
+ * Copy bytes into the queue ring buffer, taking care of wrap-around.
+ * The space must have been reserved with AbstractFifo::prepareToWrite() beforehand.
+ * @param pos	Position within m_queueBuffer at which to start writing.
+ * @param src	Source data.
+ * @param size	Number of bytes to write.
+ */
+void COscSendThread::WriteToQueue(int pos, const void* src, int size)
+{
+	const char* s = static_cast<const char*>(src);
+	int size1 = jmin(size, TX_QUEUE_SIZE - pos);
+	std::memcpy(m_queueBuffer + pos, s, static_cast<size_t>(size1));
+	if (size1 < size)
+		std::memcpy(m_queueBuffer.get(), s + size1, static_cast<size_t>(size - size1));
+}
+
+/**
+ * Copy bytes out of the queue ring buffer, taking care of wrap-around.
+ * @param dest	Destination buffer.
+ * @param size	Number of bytes to read. These must be available in the queue.
+ * @return	Number of bytes read.
+ */
+int COscSendThread::ReadFromQueue(void* dest, int size)
+{
+	int start1, size1, start2, size2;
+	m_queue.prepareToRead(size, start1, size1, start2, size2);
+
+	char* d = static_cast<char*>(dest);
+	if (size1 > 0)
+		std::memcpy(d, m_queueBuffer + start1, static_cast<size_t>(size1));
+	if (size2 > 0)
+		std::memcpy(d + size1, m_queueBuffer + start2, static_cast<size_t>(size2));
+
+	m_queue.finishedRead(size1 + size2);
+
+	return (size1 + size2);
+}
+
+/**
+ * Thread function, which sends out queued packets until the thread is asked to exit.
+ * Reimplemented from base class Thread.
+ */
+void COscSendThread::run()
+{
+	while (!threadShouldExit())
+	{
+		while (m_queue.getNumReady() >= static_cast<int>(sizeof(int)))
+		{
+			int size = 0;
+			ReadFromQueue(&size, static_cast<int>(sizeof(int)));
+			jassert((size > 0) && (size <= COscEncoder::MAX_PACKET_SIZE) && (m_queue.getNumReady() >= size));
+			ReadFromQueue(m_sendBuffer, size);
+			m_queuedPackets--;
+
+			if (m_socket->write(m_ipAddress, m_port, m_sendBuffer, size) != size)
+				m_failedPackets++;
+
+			if (threadShouldExit())
+				return;
+		}
+
+		// Sleep until EnqueuePacket() or Stop() wake us up.
+		wait(-1);
+	}
+}
+
+
+
+/*
+===============================================================================
+ Class COscReceiveThread
+===============================================================================
+*/
+
+/**
+ * Object constructor. The receive buffer is allocated here once, and reused afterwards.
+ * @param listener	Receiver of the incoming datagrams.
+ */
+COscReceiveThread::COscReceiveThread(Listener* listener)
+	: Thread("dbaudio OSC receive"),
+	m_listener(listener),
+	m_receiveBuffer(static_cast<size_t>(COscEncoder::MAX_PACKET_SIZE))
+{
+}
+
+/**
+ * Object destructor.
+ */
+COscReceiveThread::~COscReceiveThread()
+{
+	Stop();
+}
+
+/**
+ * Open the socket on the given local port, and start the receive thread.
+ * If the thread is already running, it is stopped first.
+ * @param port	Local UDP port on which to receive.
+ * @return	True if the socket could be bound to the port.
+ */
+bool COscReceiveThread::Start(int port)
+{
+	Stop();
+
+	m_socket = std::make_unique<DatagramSocket>();
+	if (!m_socket->bindToPort(port))
+	{
+		m_socket.reset();
+		return false;
+	}
+
+	startThread();
+
+	return true;
+}
+
+/**
+ * Stop the receive thread and close the socket.
+ */
+void COscReceiveThread::Stop()
+{
+	signalThreadShouldExit();
+	if (m_socket)
+		m_socket->shutdown();
+
+	stopThread(RX_STOP_TIMEOUT);
+	m_socket.reset();
+}
+
+/**
+ * Check whether the receive thread is currently running.
+ * @return	True if datagrams are currently being received.
+ */
+bool COscReceiveThread::IsRunning() const
+{
+	return isThreadRunning();
+}
+
+/**
+ * Thread function, which passes incoming datagrams on to the listener until the thread is asked to exit.
+ * The sender is read as a binary address straight from the socket, since DatagramSocket::read() 
+ * would format it into a String for every datagram. Datagrams from IPv6 senders are passed on with address 0.
+ * Reimplemented from base class Thread.
+ */
+void COscReceiveThread::run()
+{
+#if JUCE_WINDOWS
+	using SocketHandle = SOCKET;
+	using SenderLength = int;
+#else
+	using SocketHandle = int;
+	using SenderLength = socklen_t;
+#endif
+
+	while (!threadShouldExit())
+	{
+		int ready = m_socket->waitUntilReady(true, RX_WAIT_TIMEOUT);
+		if (ready < 0)
+			break;
+		if (ready == 0)
+			continue;
+
+		struct sockaddr_storage sender = {};
+		SenderLength senderLength = static_cast<SenderLength>(sizeof(sender));
+		int size = static_cast<int>(recvfrom(static_cast<SocketHandle>(m_socket->getRawSocketHandle()), m_receiveBuffer.getData(), COscEncoder::MAX_PACKET_SIZE, 0,
+			reinterpret_cast<struct sockaddr*>(&sender), &senderLength));
+
+		uint32 senderAddress = 0;
+		if (sender.ss_family == AF_INET)
+			senderAddress = static_cast<uint32>(ntohl(reinterpret_cast<const struct sockaddr_in*>(&sender)->sin_addr.s_addr));
+
+		if ((size > 0) && m_listener)
+			m_listener->oscDatagramReceived(m_receiveBuffer, size, senderAddress);
+	}
+}
+
+
+
+/*
+===============================================================================
+ Class CDeadlineTimer
+===============================================================================
+*/
+
+/**
+ * Object constructor. The timer is disabled initially.
+ * @param callback	Function to call whenever an armed deadline expires.
+ */
+CDeadlineTimer::CDeadlineTimer(std::function<void()> callback)
+	: Thread("dbaudio deadline timer"),
+	m_callback(callback),
+	m_enabled(false),
+	m_armed(false),
+	m_idle(false),
+	m_deadline(0.0)
+{
+}
+
+/**
+ * Object destructor.
+ */
+CDeadlineTimer::~CDeadlineTimer()
+{
+	SetEnabled(false);
+}
+
+/**
+ * Start or stop the timer's thread. While disabled, armed deadlines never expire.
+ * NOTE: Must always be called from the same thread.
+ * @param enabled	True to start the thread.
+ */
+void CDeadlineTimer::SetEnabled(bool enabled)
+{
+	if (enabled != m_enabled)
+	{
+		m_enabled = enabled;
+		if (enabled)
+		{
+			startThread(realtimeAudioPriority);
+		}
+		else
+		{
+			signalThreadShouldExit();
+			notify();
+			stopThread(DEADLINE_STOP_TIMEOUT);
+			m_armed = false;
+			m_idle = false;
+		}
+	}
+}
+
+/**
+ * Check whether the timer's thread is running.
+ * @return	True if armed deadlines will expire.
+ */
+bool CDeadlineTimer::IsEnabled() const
+{
+	return m_enabled;
+}
+
+/**
+ * Arm the deadline, unless it is already armed. May be called from any thread.
+ * NOTE: Only takes a lock if the timer's thread has to be woken up, i.e. if no deadline has been armed 
+ * for DEADLINE_IDLE_TIMEOUT. See run().
+ * @param delay	Time from now until the deadline expires, in milliseconds.
+ */
+void CDeadlineTimer::Arm(int delay)
+{
+	if (!m_armed)
+	{
+		m_deadline = Time::getMillisecondCounterHiRes() + delay;
+		m_armed = true;
+		if (m_idle.exchange(false))
+			notify();
+	}
+}
+
+/**
+ * Thread function, which calls the callback function once the armed deadline has expired. While no deadline is armed, 
+ * the thread keeps checking every DEADLINE_TIMER_PERIOD for DEADLINE_IDLE_TIMEOUT, so that Arm() does not have to wake it 
+ * during a burst of events, and then sleeps until woken up by Arm().
+ * Reimplemented from base class Thread.
+ */
+void CDeadlineTimer::run()
+{
+	double lastArmed = Time::getMillisecondCounterHiRes();
+
+	while (!threadShouldExit())
+	{
+		double now = Time::getMillisecondCounterHiRes();
+		if (m_armed)
+		{
+			lastArmed = now;
+			if (now >= m_deadline)
+			{
+				// Disarm before calling back, so that the callback may arm the next deadline.
+				m_armed = false;
+				if (m_callback)
+					m_callback();
+			}
+			else
+				wait(jmax(DEADLINE_TIMER_PERIOD, static_cast<int>(m_deadline - now)));
+		}
+		else if (now - lastArmed >= DEADLINE_IDLE_TIMEOUT)
+		{
+			// Arm() only wakes the thread once it has seen m_idle set. A deadline armed just before that 
+			// is caught by checking m_armed again, and a pending notification only ends the next wait early.
+			m_idle = true;
+			if (!m_armed)
+				wait(-1);
+			m_idle = false;
+			lastArmed = Time::getMillisecondCounterHiRes();
+		}
+		else
+			wait(DEADLINE_TIMER_PERIOD);
+	}
+}
+
+
+} // namespace dbaudio
@@ -0,0 +1,227 @@
+/*
+===============================================================================
+
+Copyright (C) 2019 d&b audiotechnik GmbH & Co. KG. All Rights Reserved.
+
+This file is part of the Soundscape VST, AU, and AAX Plug-in.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY d&b audiotechnik GmbH & Co. KG "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+===============================================================================
+*/
+
+
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <atomic>
+#include <functional>
+
+
+namespace dbaudio
+{
+
+
+/**
+ * Class COscSendThread owns the UDP socket used to send OSC packets to the DS100, and writes 
+ * to it from its own thread. Encoded packets are handed over through a bounded, lock-free 
+ * single-producer / single-consumer queue, so that a slow send never delays the thread which encoded 
+ * the packets. Packets are produced by the CController's timer tick, and in low-latency mode also by 
+ * its CDeadlineTimer, i.e. by two different threads.
+ * NOTE: The queue only supports a single producer: calls to EnqueuePacket(), Start() and Stop() must never overlap.
+ * CDevice guarantees this by only calling them while the CController's send lock is held, which both the timer tick
+ * and CController::SendQueuedSetCommands() hold throughout.
+ */
+class COscSendThread : private Thread
+{
+public:
+	COscSendThread();
+	~COscSendThread() override;
+
+	bool Start(const String& ipAddress, int port);
+	void Stop();
+	bool IsRunning() const;
+
+	bool EnqueuePacket(const void* data, int size);
+
+	int GetQueuedPackets() const;
+	int GetQueuedBytes() const;
+	int GetDroppedPackets() const;
+	int GetFailedPackets() const;
+
+private:
+	void run() override;
+	void WriteToQueue(int pos, const void* src, int size);
+	int ReadFromQueue(void* dest, int size);
+
+	/**
+	 * Socket on which packets are sent out. Only exists while the thread is running.
+	 */
+	std::unique_ptr<DatagramSocket>	m_socket;
+
+	/**
+	 * IP address and UDP port to which all packets are sent. Only changed while the thread is stopped.
+	 */
+	String							m_ipAddress;
+	int								m_port;
+
+	/**
+	 * Manages the read and write positions within m_queueBuffer. Each queued packet occupies 
+	 * its size as int, followed by the packet data. AbstractFifo is only safe with one writing and 
+	 * one reading thread at a time: the writer is whichever thread calls EnqueuePacket(), the reader is run().
+	 */
+	AbstractFifo					m_queue;
+
+	/**
+	 * Ring buffer holding the queued packets.
+	 */
+	HeapBlock<char>					m_queueBuffer;
+
+	/**
+	 * Buffer into which the send thread copies each packet out of the queue before sending it.
+	 */
+	HeapBlock<char>					m_sendBuffer;
+
+	/**
+	 * Number of packets currently waiting in the queue.
+	 */
+	std::atomic<int>				m_queuedPackets;
+
+	/**
+	 * Number of packets which were discarded because the queue was full.
+	 */
+	std::atomic<int>				m_droppedPackets;
+
+	/**
+	 * Number of packets which could not be written to the socket.
+	 */
+	std::atomic<int>				m_failedPackets;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(COscSendThread)
+};
+
+
+
+/**
+ * Class COscReceiveThread owns the UDP socket on which the DS100 devices send their OSC replies, 
+ * and reads from it on its own thread. Each received datagram is passed on to the Listener together 
+ * with the IPv4 address of its sender, so that replies from several devices can be told apart.
+ */
+class COscReceiveThread : private Thread
+{
+public:
+	/**
+	 * Receives the incoming datagrams.
+	 * NOTE: oscDatagramReceived() is called on the receive thread.
+	 */
+	class Listener
+	{
+	public:
+		virtual ~Listener() = default;
+		virtual void oscDatagramReceived(const char* data, int size, uint32 senderAddress) = 0;
+	};
+
+	explicit COscReceiveThread(Listener* listener);
+	~COscReceiveThread() override;
+
+	bool Start(int port);
+	void Stop();
+	bool IsRunning() const;
+
+private:
+	void run() override;
+
+	/**
+	 * Receiver of the incoming datagrams.
+	 */
+	Listener*						m_listener;
+
+	/**
+	 * Socket on which datagrams are received. Only exists while the thread is running.
+	 */
+	std::unique_ptr<DatagramSocket>	m_socket;
+
+	/**
+	 * Buffer into which each datagram is read.
+	 */
+	HeapBlock<char>					m_receiveBuffer;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(COscReceiveThread)
+};
+
+
+
+/**
+ * Class CDeadlineTimer calls a function once a short deadline has expired. The deadline may be armed from 
+ * any thread, and is checked by a thread which only runs while enabled. While deadlines keep being armed, this thread 
+ * checks for them every millisecond, and once none has been armed for a while it sleeps until the next one is armed.
+ * Arming an already armed deadline has no effect, so that a burst of events is coalesced into one callback.
+ * NOTE: The callback is called on the timer's own thread.
+ */
+class CDeadlineTimer : private Thread
+{
+public:
+	explicit CDeadlineTimer(std::function<void()> callback);
+	~CDeadlineTimer() override;
+
+	void SetEnabled(bool enabled);
+	bool IsEnabled() const;
+	void Arm(int delay);
+
+private:
+	void run() override;
+
+	/**
+	 * Function to call once the deadline has expired.
+	 */
+	std::function<void()>		m_callback;
+
+	/**
+	 * True while the thread is running, see SetEnabled().
+	 */
+	std::atomic<bool>			m_enabled;
+
+	/**
+	 * True while a deadline is pending.
+	 */
+	std::atomic<bool>			m_armed;
+
+	/**
+	 * True while the thread sleeps until the next deadline is armed. Only then does Arm() have to wake it up, 
+	 * which takes a lock. See run().
+	 */
+	std::atomic<bool>			m_idle;
+
+	/**
+	 * Time at which the pending deadline expires. See Time::getMillisecondCounterHiRes().
+	 */
+	std::atomic<double>			m_deadline;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CDeadlineTimer)
+};
+
+
+} // namespace dbaudio
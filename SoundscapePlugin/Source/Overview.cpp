@@ -44,14 +44,14 @@ namespace dbaudio
 
 
 /**
- * Rate at which the Overview GUI will refresh, when the multi-slider tab is selected.
+ * Changes which are shown on the Overview, when the table tab is selected. 
  */
-static constexpr int GUI_UPDATE_RATE_FAST = 75;
+static constexpr DataChangeTypes GUI_TABLE_CHANGES = (DCT_NumPlugins | DCT_OscConfig | DCT_RefreshInterval | DCT_PluginInstanceConfig);
 
 /**
- * Rate at which the Overview GUI will refresh.
+ * Changes which are shown on the Overview, when the multi-slider tab is selected.
  */
-static constexpr int GUI_UPDATE_RATE_SLOW = 120;
+static constexpr DataChangeTypes GUI_MULTISLIDER_CHANGES = (GUI_TABLE_CHANGES | DCT_SourcePosition);
 
 
 /*
@@ -296,6 +296,15 @@ COverviewComponent::COverviewComponent()
 	m_rateLabel = std::make_unique<CLabel>("OSC Send Rate", "Interval:");
 	addAndMakeVisible(m_rateLabel.get());
 
+	// Effective refresh interval, which may be longer than the interval if the request budget is exhausted.
+	m_refreshLabel = std::make_unique<CLabel>("Refresh Interval", "");
+	addAndMakeVisible(m_refreshLabel.get());
+
+	// Low-latency mode
+	m_lowLatencyButton = std::make_unique<CButton>("Low latency");
+	m_lowLatencyButton->addListener(this);
+	addAndMakeVisible(m_lowLatencyButton.get());
+
 	// d&b logo and Plugin version label
 	m_dbLogo = ImageCache::getFromMemory(BinaryData::logo_dbaudio_15x15_png, BinaryData::logo_dbaudio_15x15_pngSize);
 	m_versionLabel = std::make_unique<CLabel>("PluginVersion", String(JUCE_STRINGIFY(JUCE_APP_VERSION)));
@@ -329,8 +338,8 @@ COverviewComponent::COverviewComponent()
 	if (ovrMgr)
 		m_tabbedComponent->setCurrentTabIndex(ovrMgr->GetActiveTab());
 
-	// Start GUI-refreshing timer.
-	startTimer(GUI_UPDATE_RATE_SLOW);
+	// Refresh the GUI whenever the data of any Plug-in changes.
+	Subscribe(GUI_TABLE_CHANGES, nullptr);
 }
 
 /**
@@ -338,6 +347,8 @@ COverviewComponent::COverviewComponent()
  */
 COverviewComponent::~COverviewComponent()
 {
+	Unsubscribe();
+
 	// Remember which tab was active before the last time the overview was closed.
 	COverviewManager* ovrMgr = COverviewManager::GetInstance();
 	if (ovrMgr && m_tabbedComponent)
@@ -390,6 +401,8 @@ void COverviewComponent::resized()
 	// Rate
 	m_rateLabel->setBounds(Rectangle<int>(233, vStartPos2, 65, 25));
 	m_rateTextEdit->setBounds(Rectangle<int>(296, vStartPos2, 50, 25));
+	m_refreshLabel->setBounds(Rectangle<int>(355, vStartPos2, 120, 25));
+	m_lowLatencyButton->setBounds(Rectangle<int>(480, vStartPos2, 85, 25));
 
 	// Online
 	m_onlineLed->setBounds(Rectangle<int>(w - 40, vStartPos2, 24, 24));
@@ -454,10 +467,21 @@ void COverviewComponent::textEditorReturnKeyPressed(TextEditor& textEditor)
 }
 
 /**
- * Timer callback function, which will be called at regular intervals to update the GUI.
- * Reimplemented from base class Timer.
+ * Gets called when the low-latency button is clicked.
+ * @param button	The button which has been clicked.
+ */
+void COverviewComponent::buttonClicked(Button *button)
+{
+	CController* ctrl = CController::GetInstance();
+	if (ctrl && (button == m_lowLatencyButton.get()))
+		ctrl->SetLowLatencyMode(button->getToggleState());
+}
+
+/**
+ * Called on the message thread after changes to the data shown on the Overview.
+ * Reimplemented from base class AChangeSubscriber.
  */
-void COverviewComponent::timerCallback()
+void COverviewComponent::ChangesPending()
 {
 	UpdateGui(false);
 }
@@ -478,6 +502,15 @@ void COverviewComponent::UpdateGui(bool init)
 		if (ctrl->PopParameterChanged(DCS_Overview, DCT_MessageRate) || init)
 			m_rateTextEdit->setText(String(ctrl->GetRate()), false);
 
+		if (init)
+			m_lowLatencyButton->setToggleState(ctrl->GetLowLatencyMode(), dontSendNotification);
+
+		if (ctrl->PopParameterChanged(DCS_Overview, DCT_RefreshInterval) || init)
+		{
+			int refreshInterval = ctrl->GetPollRefreshInterval();
+			m_refreshLabel->setText((refreshInterval > 0) ? String::formatted("Refresh: %d ms", refreshInterval) : String(), dontSendNotification);
+		}
+
 		if (ctrl->PopParameterChanged(DCS_Overview, DCT_Online) || init)
 			m_onlineLed->setToggleState(ctrl->GetOnline(), NotificationType::dontSendNotification);
 	}
@@ -488,24 +521,16 @@ void COverviewComponent::UpdateGui(bool init)
 		if (m_tableContainer)
 			m_tableContainer->UpdateGui(init);
 
-		// When the overview table is active, no need to refresh GUI very quickly
-		if (getTimerInterval() == GUI_UPDATE_RATE_FAST)
-		{
-			//DBG("COverviewComponent::timerCallback(): Switching to GUI_UPDATE_RATE_SLOW");
-			startTimer(GUI_UPDATE_RATE_SLOW);
-		}
+		// When the overview table is active, source positions are not shown.
+		Subscribe(GUI_TABLE_CHANGES, nullptr);
 	}
 	else if (m_tabbedComponent->getCurrentTabIndex() == CTabbedComponent::OTI_MultiSlider)
 	{
 		if (m_multiSliderContainer)
 			m_multiSliderContainer->UpdateGui(init);
 
-		// When multi-slider is active, we refresh the GUI faster
-		if (getTimerInterval() == GUI_UPDATE_RATE_SLOW)
-		{
-			//DBG("COverviewComponent::timerCallback: Switching to GUI_UPDATE_RATE_FAST");
-			startTimer(GUI_UPDATE_RATE_FAST);
-		}
+		// When multi-slider is active, every source movement needs to be shown.
+		Subscribe(GUI_MULTISLIDER_CHANGES, nullptr);
 	}
 }
 
@@ -771,9 +796,10 @@ void COverviewTableContainer::UpdateGui(bool init)
 		else
 		{
 			// Iterate through all plugin instances and see if anything changed there.
-			for (int pIdx = 0; pIdx < ctrl->GetProcessorCount(); pIdx++)
+			CProcessorSnapshot::Ptr snapshot = ctrl->GetProcessorSnapshot();
+			for (int pIdx = 0; pIdx < snapshot->GetProcessorCount(); pIdx++)
 			{
-				CPlugin* plugin = ctrl->GetProcessor(pIdx);
+				CPlugin* plugin = snapshot->GetProcessor(pIdx);
 				if (plugin && plugin->PopParameterChanged(DCS_Overview, DCT_PluginInstanceConfig))
 				{
 					m_overviewTable->UpdateTable();
@@ -895,16 +921,17 @@ void COverviewMultiSurface::UpdateGui(bool init)
 		// Iterate through all plugin instances and see if anything changed there.
 		// At the same time collect all sources positions for updating.
 		CSurfaceMultiSlider::PositionCache cachedPositions;
-		for (int pIdx = 0; pIdx < ctrl->GetProcessorCount(); pIdx++)
+		CProcessorSnapshot::Ptr snapshot = ctrl->GetProcessorSnapshot();
+		for (int pIdx = 0; pIdx < snapshot->GetProcessorCount(); pIdx++)
 		{
-			CPlugin* plugin = ctrl->GetProcessor(pIdx);
+			CPlugin* plugin = snapshot->GetProcessor(pIdx);
 			if (plugin)
 			{
 				if (plugin->GetMappingId() == selectedMapping)
 				{
 					// NOTE: only sources are included, which match the selected viewing mapping.
 					Point<float> p(plugin->GetParameterValue(ParamIdx_X), plugin->GetParameterValue(ParamIdx_Y));
-					cachedPositions.insert(std::make_pair(pIdx, std::make_pair(plugin->GetSourceId(), p)));
+					cachedPositions.insert(std::make_pair(snapshot->GetProcessorId(pIdx), std::make_pair(plugin->GetSourceId(), p)));
 				}
 
 				if (plugin->PopParameterChanged(DCS_Overview, (DCT_PluginInstanceConfig | DCT_SourcePosition)))
@@ -1009,7 +1036,7 @@ PluginId CTableModelComponent::GetPluginIdForRow(int rowNumber)
 	if ((unsigned int)rowNumber > (m_ids.size() - 1))
 	{
 		jassertfalse; // Unexpected row number!
-		return 0;
+		return -1;
 	}
 
 	return m_ids.at(rowNumber);
@@ -1058,58 +1085,55 @@ void CTableModelComponent::SelectAllRows(bool all)
 
 /**
  * Helper sorting function used by std::sort(). This version is used to sort by plugin's SourceId.
- * @param pId1	Id of the first plugin processor.
- * @param pId2	Id of the second plugin processor.
+ * @param snapshot	The registered plugin processors, see CController::GetProcessorSnapshot().
+ * @param pId1		Id of the first plugin processor.
+ * @param pId2		Id of the second plugin processor.
  * @return	True if the first plugin's SourceId is less than the second's.
  */
-bool CTableModelComponent::LessThanSourceId(PluginId pId1, PluginId pId2)
+bool CTableModelComponent::LessThanSourceId(const CProcessorSnapshot& snapshot, PluginId pId1, PluginId pId2)
 {
-	CController* ctrl = CController::GetInstance();
-	if (ctrl)
-	{
-		if ((pId1 < (PluginId)ctrl->GetProcessorCount()) && (pId2 < (PluginId)ctrl->GetProcessorCount()))
-			return (ctrl->GetProcessor(pId1)->GetSourceId() < ctrl->GetProcessor(pId2)->GetSourceId());
-	}
+	const CPlugin* plugin1 = snapshot.GetProcessorById(pId1);
+	const CPlugin* plugin2 = snapshot.GetProcessorById(pId2);
+	if (plugin1 && plugin2)
+		return (plugin1->GetSourceId() < plugin2->GetSourceId());
 
-	jassertfalse; // Index out of range!
+	jassertfalse; // Plug-in was removed!
 	return false;
 }
 
 /**
  * Helper sorting function used by std::sort(). This version is used to sort by plugin's MappingId.
- * @param pId1	Id of the first plugin processor.
- * @param pId2	Id of the second plugin processor.
+ * @param snapshot	The registered plugin processors, see CController::GetProcessorSnapshot().
+ * @param pId1		Id of the first plugin processor.
+ * @param pId2		Id of the second plugin processor.
  * @return	True if the first plugin's MappingId is less than the second's.
  */
-bool CTableModelComponent::LessThanMapping(PluginId pId1, PluginId pId2)
+bool CTableModelComponent::LessThanMapping(const CProcessorSnapshot& snapshot, PluginId pId1, PluginId pId2)
 {
-	CController* ctrl = CController::GetInstance();
-	if (ctrl)
-	{
-		if ((pId1 < (PluginId)ctrl->GetProcessorCount()) && (pId2 < (PluginId)ctrl->GetProcessorCount()))
-			return (ctrl->GetProcessor(pId1)->GetMappingId() < ctrl->GetProcessor(pId2)->GetMappingId());
-	}
+	const CPlugin* plugin1 = snapshot.GetProcessorById(pId1);
+	const CPlugin* plugin2 = snapshot.GetProcessorById(pId2);
+	if (plugin1 && plugin2)
+		return (plugin1->GetMappingId() < plugin2->GetMappingId());
 
-	jassertfalse; // Index out of range!
+	jassertfalse; // Plug-in was removed!
 	return false;
 }
 
 /**
  * Helper sorting function used by std::sort(). This version is used to sort by plugin's ComsMode. 
- * @param pId1	Id of the first plugin processor.
- * @param pId2	Id of the second plugin processor.
+ * @param snapshot	The registered plugin processors, see CController::GetProcessorSnapshot().
+ * @param pId1		Id of the first plugin processor.
+ * @param pId2		Id of the second plugin processor.
  * @return	True if the first plugin's ComsMode is less than the second's.
  */
-bool CTableModelComponent::LessThanComsMode(PluginId pId1, PluginId pId2)
+bool CTableModelComponent::LessThanComsMode(const CProcessorSnapshot& snapshot, PluginId pId1, PluginId pId2)
 {
-	CController* ctrl = CController::GetInstance();
-	if (ctrl)
-	{
-		if ((pId1 < (PluginId)ctrl->GetProcessorCount()) && (pId2 < (PluginId)ctrl->GetProcessorCount()))
-			return (ctrl->GetProcessor(pId1)->GetComsMode() < ctrl->GetProcessor(pId2)->GetComsMode());
-	}
+	const CPlugin* plugin1 = snapshot.GetProcessorById(pId1);
+	const CPlugin* plugin2 = snapshot.GetProcessorById(pId2);
+	if (plugin1 && plugin2)
+		return (plugin1->GetComsMode() < plugin2->GetComsMode());
 
-	jassertfalse; // Index out of range!
+	jassertfalse; // Plug-in was removed!
 	return false;
 }
 
@@ -1122,9 +1146,10 @@ void CTableModelComponent::RecreateTableRowIds()
 	CController* ctrl = CController::GetInstance();
 	if (ctrl)
 	{
-		m_ids.reserve(ctrl->GetProcessorCount());
-		for (int idx = 0; idx < ctrl->GetProcessorCount(); ++idx)
-			m_ids.push_back(idx);
+		CProcessorSnapshot::Ptr snapshot = ctrl->GetProcessorSnapshot();
+		m_ids.reserve(snapshot->GetProcessorCount());
+		for (int idx = 0; idx < snapshot->GetProcessorCount(); ++idx)
+			m_ids.push_back(snapshot->GetProcessorId(idx));
 	}
 
 	// Clear row selection, since rows may have changed.
@@ -1227,6 +1252,11 @@ void CTableModelComponent::sortOrderChanged(int newSortColumnId, bool isForwards
 	std::vector<PluginId> selectedPlugins = GetPluginIdsForRows(GetSelectedRows());
 	m_table.deselectAllRows();
 
+	// The helper sorting functions look up the plugins in one snapshot of the processor list, 
+	// instead of asking the CController for each comparison.
+	CController* ctrl = CController::GetInstance();
+	CProcessorSnapshot::Ptr snapshot = ctrl ? ctrl->GetProcessorSnapshot() : nullptr;
+
 	// Use a different helper sorting function depending on which column is selected for sorting.
 	switch (newSortColumnId)
 	{
@@ -1234,13 +1264,16 @@ void CTableModelComponent::sortOrderChanged(int newSortColumnId, bool isForwards
 		std::sort(m_ids.begin(), m_ids.end());
 		break;
 	case OC_SourceID:
-		std::sort(m_ids.begin(), m_ids.end(), CTableModelComponent::LessThanSourceId);
+		if (snapshot)
+			std::sort(m_ids.begin(), m_ids.end(), [&snapshot](PluginId pId1, PluginId pId2) { return LessThanSourceId(*snapshot, pId1, pId2); });
 		break;
 	case OC_Mapping:
-		std::sort(m_ids.begin(), m_ids.end(), CTableModelComponent::LessThanMapping);
+		if (snapshot)
+			std::sort(m_ids.begin(), m_ids.end(), [&snapshot](PluginId pId1, PluginId pId2) { return LessThanMapping(*snapshot, pId1, pId2); });
 		break;
 	case OC_ComsMode:
-		std::sort(m_ids.begin(), m_ids.end(), CTableModelComponent::LessThanComsMode);
+		if (snapshot)
+			std::sort(m_ids.begin(), m_ids.end(), [&snapshot](PluginId pId1, PluginId pId2) { return LessThanComsMode(*snapshot, pId1, pId2); });
 		break;
 	default:
 		break;
@@ -1449,7 +1482,7 @@ void CComboBoxContainer::comboBoxChanged(ComboBox *comboBox)
 		for (std::size_t i = 0; i < pluginIds.size(); ++i)
 		{
 			// Set the value of the combobox to the current MappingID of the corresponding plugin.
-			CPlugin* plugin = ctrl->GetProcessor(pluginIds[i]);
+			CPlugin* plugin = ctrl->GetProcessorById(pluginIds[i]);
 			if (plugin)
 				plugin->SetMappingId(DCS_Overview, newMapping);
 		}
@@ -1479,7 +1512,7 @@ void CComboBoxContainer::SetRow(int newRow)
 	if (ctrl)
 	{
 		// Set the value of the combobox to the current MappingID of the corresponding plugin.
-		const CPlugin* plugin = ctrl->GetProcessor(pluginId);
+		const CPlugin* plugin = ctrl->GetProcessorById(pluginId);
 		if (plugin)
 			m_comboBox.setSelectedId(plugin->GetMappingId(), dontSendNotification);
 	}
@@ -1540,7 +1573,7 @@ void CTextEditorContainer::textEditorFocusLost(TextEditor& textEditor)
 		for (std::size_t i = 0; i < pluginIds.size(); ++i)
 		{
 			// Set the value of the combobox to the current MappingID of the corresponding plugin.
-			CPlugin* plugin = ctrl->GetProcessor(pluginIds[i]);
+			CPlugin* plugin = ctrl->GetProcessorById(pluginIds[i]);
 			if (plugin)
 				plugin->SetSourceId(DCS_Overview, newSourceId);
 		}
@@ -1586,9 +1619,17 @@ void CTextEditorContainer::SetRow(int newRow)
 	if (ctrl)
 	{
 		// Set the value of the textEditor to the current SourceID of the corresponding plugin.
-		const CPlugin* plugin = ctrl->GetProcessor(pluginId);
+		const CPlugin* plugin = ctrl->GetProcessorById(pluginId);
 		if (plugin)
+		{
 			m_editor.setText(String(plugin->GetSourceId()), false);
+
+			// Flag SourceIds which are used by several Plug-ins on the same device, since these
+			// all poll and control the same matrix input.
+			bool shared = ctrl->IsSourceIdShared(plugin->GetDeviceId(), plugin->GetSourceId());
+			m_editor.setColour(TextEditor::outlineColourId, 
+				CDbStyle::GetDbColor(shared ? CDbStyle::WarningColor : CDbStyle::WindowColor));
+		}
 	}
 }
 
@@ -1652,7 +1693,7 @@ void CRadioButtonContainer::buttonClicked(Button *button)
 
 		for (std::size_t i = 0; i < pluginIds.size(); ++i)
 		{
-			CPlugin* plugin = ctrl->GetProcessor(pluginIds[i]);
+			CPlugin* plugin = ctrl->GetProcessorById(pluginIds[i]);
 			if (plugin)
 			{
 				ComsMode oldMode = plugin->GetComsMode();
@@ -1695,7 +1736,7 @@ void CRadioButtonContainer::SetRow(int newRow)
 	if (ctrl)
 	{
 		// Toggle the correct radio buttons to the current ComsMode of the corresponding plugin.
-		const CPlugin* plugin = ctrl->GetProcessor(pluginId);
+		const CPlugin* plugin = ctrl->GetProcessorById(pluginId);
 		if (plugin)
 		{
 			const Array<AudioProcessorParameter*>& params = plugin->getParameters();
@@ -1783,7 +1824,7 @@ void CEditableLabelContainer::SetRow(int newRow)
 	if (ctrl)
 	{
 		// Set the value of the combobox to the current MappingID of the corresponding plugin.
-		CPlugin* plugin = ctrl->GetProcessor(pluginId);
+		CPlugin* plugin = ctrl->GetProcessorById(pluginId);
 		if (plugin)
 		{
 			displayName = plugin->getProgramName(0);
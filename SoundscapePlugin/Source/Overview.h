@@ -38,6 +38,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "About.h"
 #include "Gui.h"
 #include "Common.h"
+#include "Controller.h"		//<USE AChangeSubscriber, CProcessorSnapshot
 
 
 namespace dbaudio
@@ -138,7 +139,8 @@ private:
  */
 class COverviewComponent : public Component,
 	public TextEditor::Listener,
-	private Timer
+	public Button::Listener,
+	private AChangeSubscriber
 {
 public:
 	COverviewComponent();
@@ -151,8 +153,9 @@ private:
 
 	void textEditorFocusLost(TextEditor &) override;
 	void textEditorReturnKeyPressed(TextEditor &) override;
+	void buttonClicked(Button*) override;
 
-	void timerCallback() override;
+	void ChangesPending() override;
 
 private:
 	/**
@@ -195,6 +198,16 @@ private:
 	 */
 	std::unique_ptr<CTextEditor>	m_rateTextEdit;
 
+	/**
+	 * Label showing the effective interval at which each source's parameters are refreshed from the DS100.
+	 */
+	std::unique_ptr<CLabel>	m_refreshLabel;
+
+	/**
+	 * Button to toggle the low-latency mode, where local changes are sent out right away instead of at the next interval.
+	 */
+	std::unique_ptr<CButton>	m_lowLatencyButton;
+
 	/**
 	 * Button used as Online indicator LED.
 	 */
@@ -375,9 +388,9 @@ public:
 	CTableModelComponent();
 	~CTableModelComponent() override;
 
-	static bool LessThanSourceId(PluginId pId1, PluginId pId2);
-	static bool LessThanMapping(PluginId pId1, PluginId pId2);
-	static bool LessThanComsMode(PluginId pId1, PluginId pId2);
+	static bool LessThanSourceId(const CProcessorSnapshot& snapshot, PluginId pId1, PluginId pId2);
+	static bool LessThanMapping(const CProcessorSnapshot& snapshot, PluginId pId1, PluginId pId2);
+	static bool LessThanComsMode(const CProcessorSnapshot& snapshot, PluginId pId1, PluginId pId2);
 
 	PluginId GetPluginIdForRow(int rowNumber);
 	std::vector<PluginId> GetPluginIdsForRows(std::vector<int> rowNumbers);
@@ -40,11 +40,267 @@ namespace dbaudio
 {
 
 
+/*
+===============================================================================
+ Class CGestureManager
+===============================================================================
+*/
+
+/**
+ * Object constructor. Use GetInstance() to access the single, process-wide object.
+ */
+CGestureManager::CGestureManager()
+	: m_scheduled(nullptr),
+	m_currentSlot(0),
+	m_started(false)
+{
+	for (int i = 0; i < SLOT_COUNT; i++)
+		m_slots[i] = nullptr;
+}
+
+/**
+ * Returns the one and only instance of CGestureManager. It is created on first use, and lives as long as the 
+ * Plug-in binary is loaded, so that parameters can always cancel their gesture when destroyed.
+ * @return A reference to the CGestureManager.
+ */
+CGestureManager& CGestureManager::GetInstance()
+{
+	static CGestureManager instance;
+	return instance;
+}
+
+/**
+ * Hand a parameter, whose gesture has just begun, over to the manager. May be called from any thread, 
+ * and will not block. The parameter is put onto the timer wheel during the next Advance() call.
+ * @param parameter	The parameter in question. Must not already be scheduled.
+ */
+void CGestureManager::Schedule(AGestureParameter* parameter)
+{
+	AGestureParameter* head = m_scheduled.load(std::memory_order_relaxed);
+	do
+	{
+		parameter->m_nextScheduled = head;
+	} while (!m_scheduled.compare_exchange_weak(head, parameter, std::memory_order_release, std::memory_order_relaxed));
+}
+
+/**
+ * Remove a parameter from the manager, if it is there. Called when the parameter is destroyed.
+ * Waits for a running Advance() call to finish, so no BeginGesture() or EndGesture() call is made once this returns.
+ * @param parameter	The parameter in question.
+ */
+void CGestureManager::Cancel(AGestureParameter* parameter)
+{
+	const ScopedLock lock(m_mutex);
+
+	// The parameter might still be on the list of newly scheduled ones, which can only be walked by taking all of it.
+	TakeScheduled();
+
+	if (parameter->m_slot >= 0)
+		Unlink(parameter);
+}
+
+/**
+ * Visit all slots of the timer wheel whose time has passed since the last call, and end the gestures
+ * which have timed out. Parameters which were changed in the meantime are simply moved further along the wheel.
+ * NOTE: Called from the message thread by CController::handleAsyncUpdate(), without any of the CController's locks held, 
+ * so endChangeGesture() reaches the host on that thread, just like the beginChangeGesture() calls made by received values.
+ * @param now	Current time in milliseconds, see Time::getMillisecondCounter().
+ */
+void CGestureManager::Advance(uint32 now)
+{
+	const ScopedLock lock(m_mutex);
+
+	uint32 nowSlot = now / SLOT_DURATION;
+	if (!m_started)
+	{
+		m_currentSlot = nowSlot;
+		m_started = true;
+	}
+
+	TakeScheduled();
+
+	// After a long pause there is no point in visiting the same slot more than once.
+	if (static_cast<int>(nowSlot - m_currentSlot) >= SLOT_COUNT)
+		m_currentSlot = nowSlot - (SLOT_COUNT - 1);
+
+	while (static_cast<int>(nowSlot - m_currentSlot) >= 0)
+	{
+		// Detach the whole slot first, so that parameters inserted again into the same slot
+		// are not visited twice during this call.
+		int slot = static_cast<int>(m_currentSlot % SLOT_COUNT);
+		AGestureParameter* parameter = m_slots[slot];
+		m_slots[slot] = nullptr;
+
+		// Parameters whose deadline falls into this slot again go into the next one. Putting them back
+		// into this slot would delay them by a whole revolution of the wheel.
+		m_currentSlot++;
+
+		while (parameter != nullptr)
+		{
+			AGestureParameter* next = parameter->m_next;
+			parameter->m_slot = -1;
+
+			uint32 deadline;
+			if (parameter->Expire(deadline))
+				Insert(parameter, deadline);
+
+			parameter = next;
+		}
+	}
+}
+
+/**
+ * Move all parameters handed over by Schedule() onto the timer wheel. Must be called with m_mutex held.
+ */
+void CGestureManager::TakeScheduled()
+{
+	AGestureParameter* parameter = m_scheduled.exchange(nullptr, std::memory_order_acquire);
+	while (parameter != nullptr)
+	{
+		AGestureParameter* next = parameter->m_nextScheduled;
+		parameter->m_nextScheduled = nullptr;
+		Insert(parameter, parameter->m_lastChangeTime.load() + GESTURE_TIMEOUT);
+		parameter = next;
+	}
+}
+
+/**
+ * Put a parameter into the slot of the timer wheel which covers the given deadline. Must be called with m_mutex held.
+ * @param parameter	The parameter in question. Must not be on the wheel.
+ * @param deadline	Time in milliseconds at which the parameter's gesture should be checked for expiry.
+ */
+void CGestureManager::Insert(AGestureParameter* parameter, uint32 deadline)
+{
+	jassert(parameter->m_slot < 0);
+
+	// Deadlines which have already passed are handled by the next Advance() call.
+	uint32 deadlineSlot = deadline / SLOT_DURATION;
+	if (m_started && (static_cast<int>(deadlineSlot - m_currentSlot) < 0))
+		deadlineSlot = m_currentSlot;
+
+	int slot = static_cast<int>(deadlineSlot % SLOT_COUNT);
+	parameter->m_slot = slot;
+	parameter->m_prev = nullptr;
+	parameter->m_next = m_slots[slot];
+	if (m_slots[slot] != nullptr)
+		m_slots[slot]->m_prev = parameter;
+	m_slots[slot] = parameter;
+}
+
+/**
+ * Take a parameter off the timer wheel. Must be called with m_mutex held.
+ * @param parameter	The parameter in question. Must be on the wheel.
+ */
+void CGestureManager::Unlink(AGestureParameter* parameter)
+{
+	if (parameter->m_prev != nullptr)
+		parameter->m_prev->m_next = parameter->m_next;
+	else
+		m_slots[parameter->m_slot] = parameter->m_next;
+
+	if (parameter->m_next != nullptr)
+		parameter->m_next->m_prev = parameter->m_prev;
+
+	parameter->m_prev = nullptr;
+	parameter->m_next = nullptr;
+	parameter->m_slot = -1;
+}
+
+
+/*
+===============================================================================
+ Class AGestureParameter
+===============================================================================
+*/
+
+/**
+ * Object constructor.
+ */
+AGestureParameter::AGestureParameter()
+	: m_lastChangeTime(0),
+	m_gestureRunning(false),
+	m_nextScheduled(nullptr),
+	m_prev(nullptr),
+	m_next(nullptr),
+	m_slot(-1)
+{
+}
+
+/**
+ * Object destructor. Derived classes must have called CancelGesture() in their own destructor.
+ */
+AGestureParameter::~AGestureParameter()
+{
+	jassert((m_slot < 0) && (m_nextScheduled == nullptr));
+}
+
+/**
+ * Ensures that the CGestureManager no longer refers to this parameter. To be called by the destructor of derived
+ * classes, since the manager may call BeginGesture() or EndGesture() until this returns. Always takes the manager's
+ * lock, rather than checking m_gestureRunning first, since that flag is cleared by Advance() before it returns.
+ * A gesture which was running is not ended towards the host.
+ */
+void AGestureParameter::CancelGesture()
+{
+	CGestureManager::GetInstance().Cancel(this);
+}
+
+/**
+ * Check if a gesture, started by ChangeOccurred(), is currently running.
+ * @return	True between the start of the gesture and its timeout.
+ */
+bool AGestureParameter::IsGestureRunning() const
+{
+	return m_gestureRunning;
+}
+
+/**
+ * Called on every value change which did not come from a GUI gesture.
+ * If not already in the middle of a gesture, signal the start of one now. The CGestureManager will end it once
+ * the value stops changing. May be called from any thread, and will not block.
+ */
+void AGestureParameter::ChangeOccurred()
+{
+	m_lastChangeTime = Time::getMillisecondCounter();
+
+	if (!m_gestureRunning.exchange(true))
+	{
+		BeginGesture();
+		CGestureManager::GetInstance().Schedule(this);
+	}
+}
+
 /**
- * Number of CController::timerCallback() calls that are considered as the duration of a "gesture", when 
- * modifying a parameter via OSC. This is relevant for Touch automation.
+ * Called by the CGestureManager once the parameter's deadline on the timer wheel has been reached.
+ * Ends the gesture if no change occurred during the last GESTURE_TIMEOUT milliseconds.
+ * @param deadline	Returns the time in milliseconds at which the parameter needs to be checked again.
+ * @return	True if the gesture is still running, and the parameter has to be put back on the timer wheel.
  */
-static constexpr int GESTURE_LENGTH_IN_TICKS = 8;
+bool AGestureParameter::Expire(uint32& deadline)
+{
+	uint32 lastChange = m_lastChangeTime.load();
+	if (static_cast<int>(Time::getMillisecondCounter() - lastChange) < CGestureManager::GESTURE_TIMEOUT)
+	{
+		deadline = lastChange + CGestureManager::GESTURE_TIMEOUT;
+		return true;
+	}
+
+	EndGesture();
+	m_gestureRunning = false;
+
+	// ChangeOccurred() only begins a new gesture when none is running. If it was called while we were
+	// ending the gesture, its change needs a gesture as well, unless it has already started one itself.
+	lastChange = m_lastChangeTime.load();
+	if ((static_cast<int>(Time::getMillisecondCounter() - lastChange) < CGestureManager::GESTURE_TIMEOUT) &&
+		!m_gestureRunning.exchange(true))
+	{
+		BeginGesture();
+		deadline = lastChange + CGestureManager::GESTURE_TIMEOUT;
+		return true;
+	}
+
+	return false;
+}
 
 
 /*
@@ -70,7 +326,8 @@ CAudioParameterFloat::CAudioParameterFloat(String parameterID, String name, floa
 	range.interval = stepSize;
 
 	m_inGuiGesture = false;
-	m_ticksSinceLastChange = GESTURE_LENGTH_IN_TICKS + 1;
+	m_lastValue[0] = defaultValue;
+	m_lastValue[1] = defaultValue;
 }
 
 /**
@@ -78,6 +335,7 @@ CAudioParameterFloat::CAudioParameterFloat(String parameterID, String name, floa
  */
 CAudioParameterFloat::~CAudioParameterFloat()
 {
+	CancelGesture();
 }
 
 /**
@@ -116,33 +374,23 @@ void CAudioParameterFloat::EndGuiGesture()
 	{
 		endChangeGesture();
 		m_inGuiGesture = false;
-
-		// Ensure that the next CController::timerCallback() call does not trigger a endChangeGesture() call.
-		m_ticksSinceLastChange = GESTURE_LENGTH_IN_TICKS + 1;
 	}
 }
 
 /**
- * Called at every CController::timerCallback() call. 
- * Counts down the number of timer ticks that are considered as the duration of a "gesture", when 
- * modifying a parameter via OSC. This is relevant for Touch automation.
+ * Signal the host that a gesture started by a value change has begun. See AGestureParameter.
  */
-void CAudioParameterFloat::Tick()
+void CAudioParameterFloat::BeginGesture()
 {
-	const ScopedLock lock(m_mutex);
+	beginChangeGesture();
+}
 
-	// Ensure that user ist'n dragging a GUI control and already in the middle of a gesture.
-	if (!m_inGuiGesture && (m_ticksSinceLastChange <= GESTURE_LENGTH_IN_TICKS))
-	{
-		// Don't let counter grow unnecessarily into infinity, 
-		// we only need to know if maximum gesture length has been passed.
-		m_ticksSinceLastChange++;
-
-		// Once the tick counter passes the length of a gesture, 
-		// we consider the gesture ended.
-		if (m_ticksSinceLastChange > GESTURE_LENGTH_IN_TICKS)
-			endChangeGesture();
-	}
+/**
+ * Signal the host that a gesture started by a value change has ended. See AGestureParameter.
+ */
+void CAudioParameterFloat::EndGesture()
+{
+	endChangeGesture();
 }
 
 /**
@@ -152,7 +400,7 @@ void CAudioParameterFloat::Tick()
  */
 void CAudioParameterFloat::valueChanged(float newValue)
 {
-	m_lastValue[1] = m_lastValue[0];
+	m_lastValue[1] = m_lastValue[0].load();
 	m_lastValue[0] = newValue;
 }
 
@@ -172,8 +420,6 @@ float CAudioParameterFloat::GetLastValue() const
  */
 void CAudioParameterFloat::SetParameterValue(float newValue)
 {
-	const ScopedLock lock(m_mutex);
-
 	// Clip new value within allowed range for this parameter.
 	newValue = jmax(jmin(newValue, range.end), range.start);
 
@@ -181,15 +427,9 @@ void CAudioParameterFloat::SetParameterValue(float newValue)
 	if ((newValue >= (get() + range.interval)) || (newValue <= (get() - range.interval)))
 	{
 		// If user ist'n dragging a GUI control and already in the middle of a gesture, 
-		// signal the start of a gesture now.
+		// the change is part of a gesture which ends once the value stops changing.
 		if (!m_inGuiGesture)
-		{
-			if (m_ticksSinceLastChange > GESTURE_LENGTH_IN_TICKS)
-				beginChangeGesture();
-
-			// Change taking place so reset tick counter.
-			m_ticksSinceLastChange = 0;
-		}
+			ChangeOccurred();
 
 		// Map the newValue to the 0.0 to 1.0 range, and then
 		// pass the parameter value change to base class.
@@ -225,7 +465,8 @@ CAudioParameterChoice::CAudioParameterChoice(	const String& parameterID,
 												std::function<int(const String&)> indexFromString)
 	: AudioParameterChoice(parameterID, name, choices, defaultItemIndex, label, stringFromIndex, indexFromString)
 {
-	m_ticksSinceLastChange = GESTURE_LENGTH_IN_TICKS + 1;
+	m_lastIndex[0] = defaultItemIndex;
+	m_lastIndex[1] = defaultItemIndex;
 }
 
 /**
@@ -233,6 +474,7 @@ CAudioParameterChoice::CAudioParameterChoice(	const String& parameterID,
  */
 CAudioParameterChoice::~CAudioParameterChoice()
 {
+	CancelGesture();
 }
 
 /**
@@ -242,7 +484,7 @@ CAudioParameterChoice::~CAudioParameterChoice()
  */
 void CAudioParameterChoice::valueChanged(int newValue)
 {
-	m_lastIndex[1] = m_lastIndex[0];
+	m_lastIndex[1] = m_lastIndex[0].load();
 	m_lastIndex[0] = newValue;
 }
 
@@ -256,25 +498,19 @@ int CAudioParameterChoice::GetLastIndex() const
 }
 
 /**
- * Called at every CController::timerCallback() call. 
- * Counts down the number of timer ticks that are considered as the duration of a "gesture", when 
- * modifying a parameter via OSC. This is relevant for Touch automation.
+ * Signal the host that a gesture started by a value change has begun. See AGestureParameter.
  */
-void CAudioParameterChoice::Tick()
+void CAudioParameterChoice::BeginGesture()
 {
-	const ScopedLock lock(m_mutex);
+	beginChangeGesture();
+}
 
-	if (m_ticksSinceLastChange <= GESTURE_LENGTH_IN_TICKS)
-	{
-		// Don't let counter grow unnecessarily into infinity, 
-		// we only need to know if maximum gesture length has been passed.
-		m_ticksSinceLastChange++;
-
-		// Once the tick counter passes the length of a gesture, 
-		// we consider the gesture ended.
-		if (m_ticksSinceLastChange > GESTURE_LENGTH_IN_TICKS)
-			endChangeGesture();
-	}
+/**
+ * Signal the host that a gesture started by a value change has ended. See AGestureParameter.
+ */
+void CAudioParameterChoice::EndGesture()
+{
+	endChangeGesture();
 }
 
 /**
@@ -284,20 +520,13 @@ void CAudioParameterChoice::Tick()
  */
 void CAudioParameterChoice::SetParameterValue(float newValue)
 {
-	const ScopedLock lock(m_mutex);
-
 	int newChoice = static_cast<int>(newValue);
 	
 	// AudioParameterChoice::getIndex() maps the internal 0.0f - 1.0f value to the 0 to N-1 range.
 	if (getIndex() != newChoice)
 	{
-		// If user ist'n dragging a GUI control and already in the middle of a gesture, 
-		// signal the start of a gesture now.
-		if (m_ticksSinceLastChange > GESTURE_LENGTH_IN_TICKS)
-			beginChangeGesture();
-
-		// Change taking place so reset tick counter.
-		m_ticksSinceLastChange = 0;
+		// If not already in the middle of a gesture, signal the start of a gesture now.
+		ChangeOccurred();
 
 		// Pass the parameter value change to base class.
 		// NOTE: Need to map to 0.0f to 1.0f range again.
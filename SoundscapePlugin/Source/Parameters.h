@@ -36,20 +36,141 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
 #include "../JuceLibraryCode/JuceHeader.h"
+#include <atomic>
 
 
 namespace dbaudio
 {
 
 
+class AGestureParameter;
+
+
+/**
+ * Class CGestureManager, ends the host gestures which were started by parameter changes coming from OSC or from
+ * the host itself, once their parameter has not been changed for GESTURE_TIMEOUT milliseconds.
+ *
+ * Only parameters in the middle of such a gesture are known to the manager. These are kept on a hashed timer wheel,
+ * so that Advance() only visits the parameters whose timeout falls into the time which passed since the last call.
+ * Schedule() is lock-free and may be called from any thread. Advance() is called by CController::handleAsyncUpdate().
+ */
+class CGestureManager
+{
+public:
+	/**
+	 * Time in milliseconds without value changes after which a gesture is considered ended.
+	 * This is relevant for Touch automation.
+	 */
+	static constexpr int GESTURE_TIMEOUT = 400;
+
+	static CGestureManager& GetInstance();
+
+	void Schedule(AGestureParameter* parameter);
+	void Cancel(AGestureParameter* parameter);
+	void Advance(uint32 now);
+
+private:
+	/**
+	 * Number of slots on the timer wheel, and time in milliseconds covered by each slot.
+	 * One revolution of the wheel covers slightly more than GESTURE_TIMEOUT.
+	 */
+	static constexpr int SLOT_COUNT = 64;
+	static constexpr uint32 SLOT_DURATION = 8;
+
+	CGestureManager();
+
+	void TakeScheduled();
+	void Insert(AGestureParameter* parameter, uint32 deadline);
+	void Unlink(AGestureParameter* parameter);
+
+	/**
+	 * Parameters handed over by Schedule() since the last Advance() call, linked through AGestureParameter::m_nextScheduled.
+	 */
+	std::atomic<AGestureParameter*> m_scheduled;
+
+	/**
+	 * Heads of the doubly linked lists of parameters, one per slot of the timer wheel.
+	 */
+	AGestureParameter* m_slots[SLOT_COUNT];
+
+	/**
+	 * Index of the next slot period which Advance() will visit, in units of SLOT_DURATION milliseconds.
+	 */
+	uint32 m_currentSlot;
+
+	/**
+	 * True once Advance() has been called at least once, and m_currentSlot is valid.
+	 */
+	bool m_started;
+
+	/**
+	 * Serializes Advance() and Cancel(), since parameters can be destroyed while the timer is running.
+	 */
+	CriticalSection m_mutex;
+
+	JUCE_DECLARE_NON_COPYABLE(CGestureManager)
+};
+
+
+/**
+ * Class AGestureParameter, the common gesture management for automation parameters.
+ * A change through ChangeOccurred() begins a gesture, unless one is already running. The gesture is then ended by the
+ * CGestureManager, once GESTURE_TIMEOUT milliseconds have passed without further changes.
+ */
+class AGestureParameter
+{
+public:
+	AGestureParameter();
+	virtual ~AGestureParameter();
+
+	bool IsGestureRunning() const;
+
+protected:
+	void ChangeOccurred();
+	void CancelGesture();
+
+	/**
+	 * Signal the host that a gesture has started or ended. Implemented by the parameter classes.
+	 */
+	virtual void BeginGesture() = 0;
+	virtual void EndGesture() = 0;
+
+private:
+	friend class CGestureManager;
+
+	bool Expire(uint32& deadline);
+
+	/**
+	 * Time in milliseconds of the last ChangeOccurred() call, see Time::getMillisecondCounter().
+	 */
+	std::atomic<uint32> m_lastChangeTime;
+
+	/**
+	 * True between the BeginGesture() and EndGesture() calls. Whoever sets this flag is responsible for the 
+	 * BeginGesture() call and for passing the parameter to the CGestureManager.
+	 */
+	std::atomic<bool> m_gestureRunning;
+
+	/**
+	 * Links used by the CGestureManager. m_nextScheduled is used by the lock-free list of newly scheduled parameters,
+	 * the others are only accessed with the manager's lock held. m_slot is -1 while not on the timer wheel.
+	 */
+	AGestureParameter* m_nextScheduled;
+	AGestureParameter* m_prev;
+	AGestureParameter* m_next;
+	int m_slot;
+
+	JUCE_DECLARE_NON_COPYABLE(AGestureParameter)
+};
+
+
 /**
  * Class CAudioParameterFloat, a custom AudioParameterFloat which provides it's own implementation
  * of getNumSteps(), required for AAX. See this method's description for more info.
  *
- * This derivation supports automatic gesture management, which depends on the Tick() method 
- * being called regular intervals.
+ * This derivation supports automatic gesture management, see AGestureParameter.
  */
-class CAudioParameterFloat : public AudioParameterFloat
+class CAudioParameterFloat : public AudioParameterFloat, private AGestureParameter
 {
 public:
 	CAudioParameterFloat(	String parameterID, 
@@ -63,37 +184,28 @@ public:
 
 	void BeginGuiGesture();
 	void EndGuiGesture();
+	using AGestureParameter::CancelGesture;
 
 	void SetParameterValue(float);
 	float GetLastValue() const;
-	void Tick();
 
 protected:
 	int getNumSteps() const override;
 	void valueChanged(float newValue) override;
-
-	/**
-	 * Number of Tick() calls since the last value change. 
-	 */
-	int m_ticksSinceLastChange;
+	void BeginGesture() override;
+	void EndGesture() override;
 
 	/**
 	 * True if user is currently dragging or turning a GUI control, and thus in the middle of a gesture.
 	 */
-	bool m_inGuiGesture;
-
-	/**
-	 * SetParameterValue() and Tick() may be called from 2 different threads, so make sure
-	 * m_ticksSinceLastChange is handled in a tread-safe way.
-	 */
-	CriticalSection			m_mutex;
+	std::atomic<bool> m_inGuiGesture;
 
 	/**
 	 * Since AudioParameterFloat::setValue() is unfortunately private, we use this to remember
 	 * the last two values in order to detect actual value changes in AudioProcessorParameter::Listener::parameterValueChanged().
 	 * These values are normalized between 0.0f and 1.0f.
 	 */
-	float m_lastValue[2];
+	std::atomic<float> m_lastValue[2];
 
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CAudioParameterFloat)
 };
@@ -102,10 +214,9 @@ protected:
 /**
  * Class CAudioParameterChoice, a custom AudioParameterChoice.
  *
- * This derivation supports automatic gesture management, which depends on the Tick() method
- * being called regular intervals.
+ * This derivation supports automatic gesture management, see AGestureParameter.
  */
-class CAudioParameterChoice : public AudioParameterChoice
+class CAudioParameterChoice : public AudioParameterChoice, private AGestureParameter
 {
 public:
 	CAudioParameterChoice(	const String& parameterID,
@@ -118,29 +229,20 @@ public:
 
 	~CAudioParameterChoice() override;
 
+	using AGestureParameter::CancelGesture;
 	void SetParameterValue(float);
 	int GetLastIndex() const;
-	void Tick();
 
 protected:
 	void valueChanged(int newValue) override;
-
-	/**
-	 * Number of Tick() calls since the last value change.
-	 */
-	int m_ticksSinceLastChange;
-
-	/**
-	 * SetParameterValue() and Tick() may be called from 2 different threads, so make sure
-	 * m_ticksSinceLastChange is handled in a tread-safe way.
-	 */
-	CriticalSection			m_mutex;
+	void BeginGesture() override;
+	void EndGesture() override;
 
 	/**
 	 * Since AudioParameterChoice::setValue() is unfortunately private, we use this to remember
 	 * the last two values in order to detect actual value changes in AudioProcessorParameter::Listener::parameterValueChanged().
 	 */
-	int m_lastIndex[2];
+	std::atomic<int> m_lastIndex[2];
 
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CAudioParameterChoice)
 };
@@ -44,20 +44,14 @@ namespace dbaudio
 
 
 /**
- * Rate at which the GUI will refresh, after parameter changes have been detected.
- * 33 ms translates to about 30 frames per second.
+ * Changes of its own Plug-in which are shown on the GUI, see CPluginEditor::UpdateSubscription().
  */
-static constexpr int GUI_UPDATE_RATE_FAST = 33;
+static constexpr DataChangeTypes GUI_CHANGES = (DCT_AutomationParameters | DCT_PluginInstanceConfig | DCT_OscConfig | DCT_DebugMessage);
 
 /**
- * Rate at which the GUI will refresh, when no parameter changes have taken place for a while.
+ * Changes of all Plug-ins which are shown on the overview overlays (table and multi-slider).
  */
-static constexpr int GUI_UPDATE_RATE_SLOW = 120;
-
-/**
- * After this number of timer callbacks without parameter changes, the timer will switch to GUI_UPDATE_RATE_SLOW.
- */
-static constexpr int GUI_UPDATE_DELAY_TICKS = 15;
+static constexpr DataChangeTypes GUI_OVERVIEW_CHANGES = (DCT_NumPlugins | DCT_PluginInstanceConfig | DCT_SourcePosition);
 
 /*
  * Default Plug-In window size.
@@ -183,17 +177,32 @@ CPluginEditor::CPluginEditor(CPlugin& parent)
 	addAndMakeVisible(m_posAreaLabel.get());
 
 	m_sourceIdDigital = std::make_unique<CDigital>("Source Id");
-	m_sourceIdDigital->SetRange(1, 64);
+	m_sourceIdDigital->SetRange(SOURCE_ID_MIN, SOURCE_ID_MAX);
 	m_sourceIdDigital->AddListeners(this, this);
 	addAndMakeVisible(m_sourceIdDigital.get());
 
 	m_sourceIdLabel = std::make_unique<CLabel>("Source Id Label", "Input:");
 	addAndMakeVisible(m_sourceIdLabel.get());
 
+	m_deviceSelector = std::make_unique<ComboBox>("DS100 device");
+	m_deviceSelector->setEditableText(false);
+	for (int i = 1; i <= CController::DEVICE_COUNT_MAX; ++i)
+		m_deviceSelector->addItem(String(i), i);
+	m_deviceSelector->addListener(this);
+	m_deviceSelector->setColour(ComboBox::backgroundColourId, CDbStyle::GetDbColor(CDbStyle::DarkColor));
+	m_deviceSelector->setColour(ComboBox::textColourId, CDbStyle::GetDbColor(CDbStyle::TextColor));
+	m_deviceSelector->setColour(ComboBox::outlineColourId, CDbStyle::GetDbColor(CDbStyle::WindowColor));
+	m_deviceSelector->setColour(ComboBox::buttonColourId, CDbStyle::GetDbColor(CDbStyle::MidColor));
+	m_deviceSelector->setColour(ComboBox::arrowColourId, CDbStyle::GetDbColor(CDbStyle::TextColor));
+	addAndMakeVisible(m_deviceSelector.get());
+
+	m_deviceLabel = std::make_unique<CLabel>("DS100 device label", "DS100:");
+	addAndMakeVisible(m_deviceLabel.get());
+
 	m_ipAddressTextEdit = std::make_unique<CTextEditor>("IP Address");
 	m_ipAddressTextEdit->addListener(this);
 	addAndMakeVisible(m_ipAddressTextEdit.get());
-	m_ipAddressLabel = std::make_unique<CLabel>("IP Address Label", "IP Address:");
+	m_ipAddressLabel = std::make_unique<CLabel>("IP Address Label", "IP:");
 	addAndMakeVisible(m_ipAddressLabel.get());
 
 	m_onlineLed = std::make_unique<CButton>("");
@@ -290,8 +299,9 @@ CPluginEditor::CPluginEditor(CPlugin& parent)
 	// Allow resizing of plugin window.
 	setResizable(true, true);
 
-	// Start GUI-refreshing timer.
-	startTimer(GUI_UPDATE_RATE_FAST);
+	// Refresh the GUI whenever the Plug-in's data changes.
+	UpdateSubscription();
+	UpdateGui(false);
 }
 
 /**
@@ -299,7 +309,7 @@ CPluginEditor::CPluginEditor(CPlugin& parent)
  */
 CPluginEditor::~CPluginEditor()
 {
-	stopTimer();
+	Unsubscribe();
 }
 
 /**
@@ -434,6 +444,11 @@ void CPluginEditor::comboBoxChanged(ComboBox *comboBox)
 			pro->SetMappingId(DCS_Gui, comboBox->getSelectedId());
 		}
 
+		else if (comboBox == m_deviceSelector.get())
+		{
+			pro->SetDeviceId(DCS_Gui, comboBox->getSelectedId() - 1);
+		}
+
 		else if (comboBox == m_delayModeComboBox.get())
 		{
 			pro->SetParameterValue(DCS_Gui, ParamIdx_DelayMode, float(comboBox->getSelectedId() - 1));
@@ -605,6 +620,21 @@ void CPluginEditor::ToggleOverlay(AOverlay::OverlayType type)
 		addAndMakeVisible(m_overlay.get());
 		resized();
 	}
+
+	UpdateSubscription();
+}
+
+/**
+ * Adapt the changes which wake the GUI to the active overlay. The overview overlays show all Plug-ins, 
+ * so changes of any Plug-in need to wake them. Otherwise, only changes of this Plug-in are of interest.
+ */
+void CPluginEditor::UpdateSubscription()
+{
+	AOverlay::OverlayType overlayType = (m_overlay != nullptr) ? m_overlay->GetOverlayType() : AOverlay::OT_Unknown;
+	if ((overlayType == AOverlay::OT_Overview) || (overlayType == AOverlay::OT_MultiSlide))
+		Subscribe((GUI_CHANGES | GUI_OVERVIEW_CHANGES), nullptr);
+	else
+		Subscribe(GUI_CHANGES, dynamic_cast<CPlugin*>(getAudioProcessor()));
 }
 
 /**
@@ -698,9 +728,11 @@ void CPluginEditor::resized()
 		m_oscModeReceive->setBounds(Rectangle<int>(w - 154, vStartPos, 35, 25));
 	}
 
-	// Ip Address
-	m_ipAddressLabel->setBounds(Rectangle<int>(5, vStartPos2, 75, 25));
-	m_ipAddressTextEdit->setBounds(Rectangle<int>(80, vStartPos2, 140, 25));
+	// Device selector and its Ip Address
+	m_deviceLabel->setBounds(Rectangle<int>(5, vStartPos2, 50, 25));
+	m_deviceSelector->setBounds(Rectangle<int>(52, vStartPos2, 42, 25));
+	m_ipAddressLabel->setBounds(Rectangle<int>(97, vStartPos2, 25, 25));
+	m_ipAddressTextEdit->setBounds(Rectangle<int>(120, vStartPos2, 108, 25));
 
 	// Rate
 	m_rateLabel->setBounds(Rectangle<int>(233, vStartPos2, 65, 25));
@@ -747,10 +779,10 @@ void CPluginEditor::resized()
 }
 
 /**
- * Timer callback function, which will be called at regular intervals to update the GUI.
- * Reimplemented from base class Timer.
+ * Called on the message thread after changes to the data shown on the GUI, see UpdateSubscription().
+ * Reimplemented from base class AChangeSubscriber.
  */
-void CPluginEditor::timerCallback()
+void CPluginEditor::ChangesPending()
 {
 	// If there is an overlay currenly active, update it.
 	if (m_overlay)
@@ -769,18 +801,17 @@ void CPluginEditor::UpdateGui(bool init)
 {
 	ignoreUnused(init); // No need to use this here so far.
 
-	bool somethingChanged = false;
-
 	CPlugin* pro = dynamic_cast<CPlugin*>(getAudioProcessor());
 	if (pro)
 	{
 		const Array<AudioProcessorParameter*>& params = pro->getParameters();
 		AudioParameterFloat* fParam;
 
-		// See if any parameters changed since the last timer callback.
-		somethingChanged = (pro->GetParameterChanged(DCS_Gui, DCT_AutomationParameters) ||
-							pro->GetParameterChanged(DCS_Gui, DCT_PluginInstanceConfig) ||
-							pro->GetParameterChanged(DCS_Gui, DCT_OscConfig));
+		// Global settings are not flagged on each Plug-in, but published by the CController's generation counters.
+		DataChangeTypes globalChanges = DCT_None;
+		CController* ctrl = CController::GetInstanceWithoutCreating();
+		if (ctrl)
+			globalChanges = ctrl->PopGlobalChanges(m_globalGenerations);
 
 		if (pro->PopParameterChanged(DCS_Gui, DCT_SourcePosition))
 		{
@@ -851,19 +882,25 @@ void CPluginEditor::UpdateGui(bool init)
 			}
 		}
 
-		if (pro->PopParameterChanged(DCS_Gui, DCT_IPAddress))
+		if (pro->PopParameterChanged(DCS_Gui, DCT_DeviceID))
+		{
+			// Update device selector. Need to add 1 because device indices start at 0, while the combo box's ID's start at 1.
+			m_deviceSelector->setSelectedId(pro->GetDeviceId() + 1, dontSendNotification);
+		}
+
+		if (pro->PopParameterChanged(DCS_Gui, DCT_IPAddress) || ((globalChanges & DCT_IPAddress) != DCT_None))
 		{
 			// Update IP address field
 			m_ipAddressTextEdit->setText(pro->GetIpAddress());
 		}
 
-		if (pro->PopParameterChanged(DCS_Gui, DCT_MessageRate))
+		if (pro->PopParameterChanged(DCS_Gui, DCT_MessageRate) || ((globalChanges & DCT_MessageRate) != DCT_None))
 		{
 			// Update message rate field
 			m_rateTextEdit->setText(String(pro->GetMessageRate()));
 		}
 
-		if (pro->PopParameterChanged(DCS_Gui, DCT_Online))
+		if (pro->PopParameterChanged(DCS_Gui, DCT_Online) || ((globalChanges & DCT_Online) != DCT_None))
 		{
 			// Update online status
 			m_onlineLed->setToggleState(pro->GetOnline(), dontSendNotification);
@@ -878,39 +915,6 @@ void CPluginEditor::UpdateGui(bool init)
 		}
 #endif
 	}
-
-	// Whenever the Multi-slider overlay is active, switch to fast refresh for smoother movements 
-	// even if nothing changes in this plugin (there may be position changes in other plugins).
-	if ((m_overlay != nullptr) &&
-		(m_overlay->GetOverlayType() == AOverlay::OT_MultiSlide))
-		somethingChanged = true;
-
-	if (somethingChanged)
-	{
-		// At least one parameter was changed -> reset counter to prevent switching to "slow" refresh rate too soon.
-		m_ticksSinceLastChange = 0;
-
-		// Parameters have changed in the plugin: Switch to frequent GUI refreshing rate
-		if (getTimerInterval() == GUI_UPDATE_RATE_SLOW)
-		{
-			startTimer(GUI_UPDATE_RATE_FAST);
-			DBG("CPluginEditor::timerCallback: Switching to GUI_UPDATE_RATE_FAST");
-		}
-	}
-
-	else
-	{
-		// No parameter changed since last timer callback -> increase counter.
-		if (m_ticksSinceLastChange < GUI_UPDATE_DELAY_TICKS)
-			m_ticksSinceLastChange++;
-
-		// Once counter has reached a certain limit: Switch to lazy GUI refreshing rate
-		else if (getTimerInterval() == GUI_UPDATE_RATE_FAST)
-		{
-			DBG("CPluginEditor::timerCallback(): Switching to GUI_UPDATE_RATE_SLOW");
-			startTimer(GUI_UPDATE_RATE_SLOW);
-		}
-	}
 }
 
 
@@ -35,6 +35,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #pragma once
 
+#include "Controller.h"		//<USE CController::GlobalGenerations
 #include "Gui.h"
 #include "SurfaceSlider.h"
 #include <utility>	//<USE std::unique_ptr
@@ -53,7 +54,7 @@ class CPluginEditor :
 	public Slider::Listener,
 	public ComboBox::Listener,
 	public Button::Listener,
-	private Timer
+	private AChangeSubscriber
 {
 public:
 	CPluginEditor(CPlugin&);
@@ -73,7 +74,8 @@ private:
 	void textEditorReturnKeyPressed(TextEditor &) override;
 	void comboBoxChanged(ComboBox *comboBox) override;
 	void buttonClicked(Button*) override;
-	void timerCallback() override;
+	void ChangesPending() override;
+	void UpdateSubscription();
 
 	/**
 	 * Horizontal slider for X axis.
@@ -150,6 +152,11 @@ private:
 	 */
 	std::unique_ptr<CLabel>	m_ipAddressLabel;
 
+	/*
+	 * DS100 device label
+	 */
+	std::unique_ptr<CLabel>	m_deviceLabel;
+
 	/*
 	 * Send/receive rate label
 	 */
@@ -160,6 +167,11 @@ private:
 	 */
 	std::unique_ptr<ComboBox>	m_areaSelector;
 
+	/*
+	 * ComboBox selector for the DS100 device
+	 */
+	std::unique_ptr<ComboBox>	m_deviceSelector;
+
 	/*
 	 * Text editor for the source ID (matrix input)
 	 */
@@ -227,11 +239,9 @@ private:
 	std::unique_ptr<CDiscreteButton> m_aboutButton;
 
 	/**
-	 * Used to allow some tolerance when switching between fast and slow refresh rates for the GUI. 
-	 * Once this counter reaches GUI_UPDATE_DELAY_TICKS, and no parameters have changed, the GUI will
-	 * switch to GUI_UPDATE_RATE_SLOW. Switches to GUI_UPDATE_RATE_FAST happen immediately after any change.
+	 * Generations of the CController's global settings (IP address, rate, Online status) which the GUI last showed.
 	 */
-	int m_ticksSinceLastChange = 0;
+	CController::GlobalGenerations m_globalGenerations;
 
 	/**
 	 * Keep track of the user's preferred Plug-In window size, and use it when opening a fresh window.
@@ -46,9 +46,23 @@ namespace dbaudio
 {
 
 
-static constexpr SourceId SOURCE_ID_MIN = 1;		//< Minimum maxtrix input number / SourceId
-static constexpr SourceId SOURCE_ID_MAX = 64;		//< Highest maxtrix input number / SourceId
 static constexpr int DEFAULT_COORD_MAPPING = 1;		//< Default coordinate mapping
+static constexpr int POLL_INTERVAL_MAX = 2000;		//< Longest interval between GET commands for an idle parameter, in milliseconds
+static constexpr int POLL_IDLE_TIME = 1000;			//< Milliseconds without value change after which a parameter is considered idle
+static constexpr int POLL_ACTIVITY_BITS = 2;		//< Bits per OscCommand in CPlugin::m_pollActivity
+static constexpr uint32 POLL_ACTIVITY_SEEN = 0x1;	//< A value of the OscCommand was received or sent
+static constexpr uint32 POLL_ACTIVITY_CHANGED = 0x2;	//< A value of the OscCommand differed from the previous one
+
+/**
+ * Changes which require this Plug-in to be visited during the next CController timer tick,
+ * either to send out SET commands, to start polling, or to end an automation gesture.
+ */
+static constexpr DataChangeTypes DCT_TickRelevant = (DCT_AutomationParameters | DCT_PluginInstanceConfig);
+
+/**
+ * Changes which are sent out as SET commands, and may thus take the low-latency path.
+ */
+static constexpr DataChangeTypes DCT_SetRelevant = (DCT_SourcePosition | DCT_ReverbSendGain | DCT_SourceSpread | DCT_DelayMode);
 
 /*
 ===============================================================================
@@ -61,6 +75,20 @@ static constexpr int DEFAULT_COORD_MAPPING = 1;		//< Default coordinate mapping
  */
 CPlugin::CPlugin()
 {
+	// Not on any of the CController's lists yet.
+	for (int q = 0; q < PQ_Max; q++)
+	{
+		m_queued[q] = false;
+		m_nextQueued[q] = nullptr;
+	}
+
+	// No parameter changes in progress.
+	for (int i = 0; i < CHANGE_SOURCE_SLOTS; i++)
+	{
+		m_changeSources[i].thread = nullptr;
+		m_changeSources[i].source = DCS_Host;
+	}
+
 	// Automation parameters.
 	m_xPos = new CAudioParameterFloat("x_pos", "x", 0.0f, 1.0f, 0.001f, 0.5f);
 	m_yPos = new CAudioParameterFloat("y_pos", "y", 0.0f, 1.0f, 0.001f, 0.5f);
@@ -92,19 +120,26 @@ CPlugin::CPlugin()
 
 	m_sourceId = SOURCE_ID_MIN; // This default sourceId will be overwritten by ctrl->AddProcessor() below.
 	m_mappingId = DEFAULT_COORD_MAPPING; // Default: coordinate mapping 1.
+	m_deviceId = 0; // Default: first DS100 of the device table.
 	m_pluginId = -1;
+	m_oscAddressCache.Update(m_mappingId, m_sourceId);
+	m_oscAddressCacheStale = false;
+	m_pollActivity = 0;
+	ResetPollIntervals();
 
 	// Default OSC communication mode. In the console version, default is "sync" mode.
 	if (IsTargetHostAvidConsole())
 		m_comsMode = CM_Sync;
 	else 
 		m_comsMode = CM_Tx;
-	m_comsModeWhenNotBypassed = m_comsMode;
+	m_comsModeWhenNotBypassed = m_comsMode.load();
+	m_paramSetCommandsInTransit = DCT_None;
 
 	// Start with all parameter changed flags cleared. Function setStateInformation() 
 	// will check whether or not we should initialize parameters when starting up.
 	for (int cs = 0; cs < DCS_Max; cs++)
 		m_parametersChanged[cs] = DCT_None;
+	m_pendingNotifications = DCT_None;
 
 	// Register this new plugin instance to the singleton CController object's internal list.
 	CController* ctrl = CController::GetInstance();
@@ -121,6 +156,15 @@ CPlugin::~CPlugin()
 	CController* ctrl = CController::GetInstance();
 	if (ctrl)
 		ctrl->RemoveProcessor(this);
+
+	// The parameters are only destroyed by the AudioProcessor base class. Until then the CGestureManager 
+	// could still end their gestures, which notifies this object as their listener.
+	m_xPos->CancelGesture();
+	m_yPos->CancelGesture();
+	m_reverbSendGain->CancelGesture();
+	m_sourceSpread->CancelGesture();
+	m_delayMode->CancelGesture();
+	m_bypassParam->CancelGesture();
 }
 
 /**
@@ -132,7 +176,7 @@ CPlugin::~CPlugin()
  */
 bool CPlugin::GetParameterChanged(DataChangeSource changeSource, DataChangeTypes change)
 {
-	return ((m_parametersChanged[changeSource] & change) != 0);
+	return ((m_parametersChanged[changeSource].load() & change) != 0);
 }
 
 /**
@@ -145,9 +189,9 @@ bool CPlugin::GetParameterChanged(DataChangeSource changeSource, DataChangeTypes
  */
 bool CPlugin::PopParameterChanged(DataChangeSource changeSource, DataChangeTypes change)
 {
-	bool ret((m_parametersChanged[changeSource] & change) != 0);
-	m_parametersChanged[changeSource] &= ~change; // Reset flag.
-	return ret;
+	// Reset flag, and check its state before resetting in the same atomic operation.
+	DataChangeTypes previous = m_parametersChanged[changeSource].fetch_and(~change);
+	return ((previous & change) != 0);
 }
 
 /**
@@ -164,10 +208,44 @@ void CPlugin::SetParameterChanged(DataChangeSource changeSource, DataChangeTypes
 		// do not set the specified change flag for OSC. This would trigger an 
 		// OSC Set command to go out for every received message.
 		if ((changeSource != DCS_Osc) || (cs != DCS_Osc))
-			m_parametersChanged[cs] |= changeTypes;
+			m_parametersChanged[cs].fetch_or(changeTypes);
+	}
+
+	// The CController is created together with the first Plug-in, so there is no need to create it here.
+	// This matters for host changes, which may come in on the audio thread, where we must not allocate.
+	CController* ctrl = CController::GetInstanceWithoutCreating();
+	if (ctrl)
+	{
+		// Waking the GUIs takes a lock and posts a message, so for host changes this is left to 
+		// the CController's timer thread, which picks them up through PopPendingNotifications().
+		bool notifyLater = (changeSource == DCS_Host);
+		if (notifyLater)
+			m_pendingNotifications.fetch_or(changeTypes);
+
+		// Make sure the CController looks at this Plug-in during its next timer tick.
+		if (notifyLater || ((changeTypes & DCT_TickRelevant) != DCT_None))
+			ctrl->QueueProcessorForTick(this);
+
+		// Local changes may also be sent out right away, see CController::SetLowLatencyMode().
+		if ((changeSource != DCS_Osc) && ((changeTypes & DCT_SetRelevant) != DCT_None))
+			ctrl->QueueProcessorForSet(this);
+
+		// Wake the GUIs which show this Plug-in's data.
+		if (!notifyLater)
+			ctrl->NotifyChangeSubscribers(this, changeTypes);
 	}
 }
 
+/**
+ * Take the changes made by the host which the GUIs have not been woken for yet, and reset them.
+ * Called by the CController's timer thread, see SetParameterChanged().
+ * @return	The changes since the last call, or DCT_None.
+ */
+DataChangeTypes CPlugin::PopPendingNotifications()
+{
+	return m_pendingNotifications.exchange(DCT_None);
+}
+
 /**
  * Get the current value of a specific automation parameter.
  * @param paramIdx	The index of the desired parameter.
@@ -242,8 +320,10 @@ void CPlugin::SetParameterValue(DataChangeSource changeSource, AutomationParamet
 {
 	// The reimplemented method AudioProcessor::parameterValueChanged() will trigger a SetParameterChanged() call.
 	// We need to ensure that this change is registered to the correct source. 
-	// We set the source here, so that it can be used in parameterValueChanged(). 
-	m_currentChangeSource = changeSource;
+	// We register the source for this thread here, so that it can be used in parameterValueChanged(), which is called 
+	// synchronously on this thread. Changes made concurrently on other threads keep their own source.
+	DataChangeSource previousChangeSource;
+	int changeSourceSlot = PushChangeSource(changeSource, previousChangeSource);
 
 	switch (paramIdx)
 	{
@@ -270,49 +350,267 @@ void CPlugin::SetParameterValue(DataChangeSource changeSource, AutomationParamet
 		break;
 	}
 
-	// After the SetParameterChanged() call has been triggered, set the change source to the default.
-	// The host is the only one which can call parameterValueChanged directly. All other modules of the
-	// application do it over this method.
-	m_currentChangeSource = DCS_Host;
+	// After the SetParameterChanged() call has been triggered, unregister the change source, or restore it if 
+	// this call is nested. The host is the only one which can call parameterValueChanged directly. 
+	// All other modules of the application do it over this method.
+	PopChangeSource(changeSourceSlot, previousChangeSource);
 }
 
 /**
- * This method should be called once every timer callback tick of the CController. 
- * The signal is passed on to all automation parameters. This is used to trigger gestures for touch automation.
+ * Register the source of a parameter change which the calling thread is about to make, see GetChangeSource().
+ * @param changeSource		The application module which is causing the property change.
+ * @param previousSource	Set to the source registered for this thread before, or DCS_Max if there was none.
+ * @return	The slot within m_changeSources used by this thread, or -1 if all slots are in use by other threads.
  */
-void CPlugin::Tick()
+int CPlugin::PushChangeSource(DataChangeSource changeSource, DataChangeSource& previousSource)
 {
-	// Reset the flags indicating when a parameter's SET command is out on the network. 
-	// These flags are set during CController::timerCallback() and queried in CController::oscMessageReceived()
-	m_paramSetCommandsInTransit = DCT_None;
+	const Thread::ThreadID thisThread = Thread::getCurrentThreadId();
 
-	for (int pIdx = 0; pIdx < ParamIdx_MaxIndex; pIdx++)
+	// Nested call on this thread.
+	for (int i = 0; i < CHANGE_SOURCE_SLOTS; i++)
 	{
-		switch (pIdx)
+		if (m_changeSources[i].thread == thisThread)
 		{
-		case ParamIdx_X:
-			m_xPos->Tick();
-			break;
-		case ParamIdx_Y:
-			m_yPos->Tick();
-			break;
-		case ParamIdx_ReverbSendGain:
-			m_reverbSendGain->Tick();
-			break;
-		case ParamIdx_SourceSpread:
-			m_sourceSpread->Tick();
-			break;
-		case ParamIdx_DelayMode:
-			m_delayMode->Tick();
-			break;
-		case ParamIdx_Bypass:
-			m_bypassParam->Tick();
-			break;
-		default:
-			jassert(false); // missing implementation!
-			break;
+			previousSource = m_changeSources[i].source;
+			m_changeSources[i].source = changeSource;
+			return i;
 		}
 	}
+
+	// The source is only ever read by this thread, so it may be written after claiming the slot.
+	previousSource = DCS_Max;
+	for (int i = 0; i < CHANGE_SOURCE_SLOTS; i++)
+	{
+		Thread::ThreadID expected = nullptr;
+		if (m_changeSources[i].thread.compare_exchange_strong(expected, thisThread))
+		{
+			m_changeSources[i].source = changeSource;
+			return i;
+		}
+	}
+
+	// More threads than CHANGE_SOURCE_SLOTS change parameters at once, so this change will be registered to the host.
+	jassertfalse;
+	return -1;
+}
+
+/**
+ * Unregister the source of a parameter change which the calling thread has completed.
+ * @param slot				The slot returned by PushChangeSource().
+ * @param previousSource	The source returned by PushChangeSource(), which is restored.
+ */
+void CPlugin::PopChangeSource(int slot, DataChangeSource previousSource)
+{
+	if (slot < 0)
+		return;
+
+	if (previousSource != DCS_Max)
+		m_changeSources[slot].source = previousSource;
+	else
+		m_changeSources[slot].thread = nullptr;
+}
+
+/**
+ * Source of the parameter change which the calling thread is currently making through SetParameterValue().
+ * Neither locks nor allocates, since it is also called on the host's audio thread.
+ * @return	The registered source, or DCS_Host if this thread has not registered any.
+ */
+DataChangeSource CPlugin::GetChangeSource() const
+{
+	const Thread::ThreadID thisThread = Thread::getCurrentThreadId();
+	for (int i = 0; i < CHANGE_SOURCE_SLOTS; i++)
+		if (m_changeSources[i].thread == thisThread)
+			return m_changeSources[i].source;
+
+	return DCS_Host;
+}
+
+/**
+ * Flag this Plug-in as being on one of the CController's lists of Plug-ins to visit. May be called from any thread.
+ * @param queue	The list in question.
+ * @return	True if the flag was not set before, i.e. the caller is now responsible for adding this Plug-in to the list.
+ */
+bool CPlugin::MarkQueued(ProcessorQueue queue)
+{
+	return !m_queued[queue].exchange(true);
+}
+
+/**
+ * Clear the flag set by MarkQueued(), once the CController has taken this Plug-in off the list.
+ * @param queue	The list in question.
+ */
+void CPlugin::ClearQueued(ProcessorQueue queue)
+{
+	m_queued[queue].store(false);
+}
+
+/**
+ * Getter for the link to the next Plug-in on one of the CController's lists of Plug-ins to visit.
+ * @param queue	The list in question.
+ * @return	Next Plug-in on the list, or nullptr if this is the last one.
+ */
+CPlugin* CPlugin::GetNextQueued(ProcessorQueue queue) const
+{
+	return m_nextQueued[queue];
+}
+
+/**
+ * Setter for the link to the next Plug-in on one of the CController's lists of Plug-ins to visit.
+ * @param queue	The list in question.
+ * @param next	Next Plug-in on the list, or nullptr if this is the last one.
+ */
+void CPlugin::SetNextQueued(ProcessorQueue queue, CPlugin* next)
+{
+	m_nextQueued[queue] = next;
+}
+
+/**
+ * Getter for the time at which SET commands were last sent out over the low-latency path.
+ * @return	Time of the last SET commands, see Time::getMillisecondCounter().
+ */
+uint32 CPlugin::GetLastSetTime() const
+{
+	return m_lastSetTime;
+}
+
+/**
+ * Setter for the time at which SET commands were last sent out over the low-latency path.
+ * @param time	Time of the SET commands, see Time::getMillisecondCounter().
+ */
+void CPlugin::SetLastSetTime(uint32 time)
+{
+	m_lastSetTime = time;
+}
+
+/**
+ * Check whether a GET command for the given OscCommand should be sent, according to its current poll interval.
+ * @param command	The OSC command to check.
+ * @param now		Current time, see Time::getMillisecondCounter().
+ * @return	True if the poll interval has elapsed since the last GET command.
+ */
+bool CPlugin::IsPollDue(OscCommand command, uint32 now)
+{
+	ApplyPendingPollReset();
+	ApplyPendingPollActivity();
+
+	return (static_cast<int>(now - m_nextPollTime[command]) >= 0);
+}
+
+/**
+ * Getter for the current interval between GET commands for the given OscCommand.
+ * @param command	The OSC command.
+ * @return	Current poll interval in milliseconds.
+ */
+int CPlugin::GetPollInterval(OscCommand command)
+{
+	ApplyPendingPollReset();
+	ApplyPendingPollActivity();
+
+	return m_pollInterval[command];
+}
+
+/**
+ * A GET command for the given OscCommand has just been sent out. The next one will be due once
+ * the current poll interval has elapsed.
+ * @param command	The OSC command which was sent.
+ * @param now		Current time, see Time::getMillisecondCounter().
+ */
+void CPlugin::SetPollSent(OscCommand command, uint32 now)
+{
+	ApplyPendingPollReset();
+	ApplyPendingPollActivity();
+
+	m_nextPollTime[command] = now + static_cast<uint32>(m_pollInterval[command]);
+}
+
+/**
+ * Report the activity of the given OscCommand's parameter(s), which adapts its poll interval. Any change resets the
+ * interval to the minimum, while unchanged responses of an idle parameter double it, up to POLL_INTERVAL_MAX.
+ * May be called from any thread: the activity is applied by the thread which sends the GET commands,
+ * the next time it looks at the poll state. See ApplyPendingPollActivity().
+ * @param command		The OSC command whose parameter(s) were received or sent.
+ * @param valueChanged	True if the value differs from the previous one.
+ */
+void CPlugin::SetPollActivity(OscCommand command, bool valueChanged)
+{
+	uint32 activity = valueChanged ? (POLL_ACTIVITY_SEEN | POLL_ACTIVITY_CHANGED) : POLL_ACTIVITY_SEEN;
+	m_pollActivity.fetch_or(activity << (command * POLL_ACTIVITY_BITS));
+}
+
+/**
+ * Apply the activity reported by SetPollActivity() since the last time to the poll intervals. Called by all methods 
+ * which access the poll state, after ApplyPendingPollReset(), so that it is only ever written by the thread which sends OSC messages.
+ */
+void CPlugin::ApplyPendingPollActivity()
+{
+	uint32 activity = m_pollActivity.exchange(0);
+	if (activity == 0)
+		return;
+
+	const uint32 now = Time::getMillisecondCounter();
+
+	for (int cmd = 0; cmd < OscCmd_MaxIndex; ++cmd, activity >>= POLL_ACTIVITY_BITS)
+	{
+		if ((activity & POLL_ACTIVITY_SEEN) == POLL_ACTIVITY_SEEN)
+			UpdatePollInterval(cmd, ((activity & POLL_ACTIVITY_CHANGED) == POLL_ACTIVITY_CHANGED), now);
+	}
+}
+
+/**
+ * Adapt the poll interval of the given OscCommand to the activity of its parameter(s), see SetPollActivity().
+ * @param command		The OSC command whose parameter(s) were received or sent.
+ * @param valueChanged	True if the value differs from the previous one.
+ * @param now			Current time, see Time::getMillisecondCounter().
+ */
+void CPlugin::UpdatePollInterval(int command, bool valueChanged, uint32 now)
+{
+	const int intervalMin = CController::GetSupportedRateRange().first;
+
+	if (valueChanged)
+	{
+		m_lastPollChangeTime[command] = now;
+		if (m_pollInterval[command] > intervalMin)
+		{
+			// Poll again right away, rather than waiting out the long interval of the idle phase.
+			m_pollInterval[command] = intervalMin;
+			m_nextPollTime[command] = now;
+		}
+	}
+	else if (static_cast<int>(now - m_lastPollChangeTime[command]) > POLL_IDLE_TIME)
+	{
+		m_pollInterval[command] = jmin(POLL_INTERVAL_MAX, m_pollInterval[command] * 2);
+	}
+}
+
+/**
+ * Poll all parameters at the minimum interval, starting right away. Used whenever the polled
+ * address or the Rx/Tx mode changes, since previous activity says nothing about the new situation.
+ * May be called from any thread: the reset itself is done by the thread which sends the GET commands,
+ * the next time it looks at the poll state. See ApplyPendingPollReset().
+ */
+void CPlugin::ResetPollIntervals()
+{
+	m_pollResetPending = true;
+}
+
+/**
+ * Reset the poll state, if ResetPollIntervals() has been called since the last time. Called by all methods 
+ * which access the poll state, so that it is only ever written by the thread which sends OSC messages.
+ */
+void CPlugin::ApplyPendingPollReset()
+{
+	if (!m_pollResetPending.exchange(false))
+		return;
+
+	const int intervalMin = CController::GetSupportedRateRange().first;
+	const uint32 now = Time::getMillisecondCounter();
+
+	for (int cmd = 0; cmd < OscCmd_MaxIndex; ++cmd)
+	{
+		m_pollInterval[cmd] = intervalMin;
+		m_nextPollTime[cmd] = now;
+		m_lastPollChangeTime[cmd] = now;
+	}
 }
 
 /**
@@ -321,7 +619,16 @@ void CPlugin::Tick()
  */
 void CPlugin::SetParamInTransit(DataChangeTypes paramsChanged)
 {
-	m_paramSetCommandsInTransit |= paramsChanged;
+	m_paramSetCommandsInTransit.fetch_or(paramsChanged);
+}
+
+/**
+ * Reset the flags indicating when a parameter's SET command is out on the network. Called by 
+ * CController::hiResTimerCallback() during the first tick after received values have been applied.
+ */
+void CPlugin::ClearParamInTransit()
+{
+	m_paramSetCommandsInTransit = DCT_None;
 }
 
 /**
@@ -358,7 +665,16 @@ void CPlugin::getStateInformation(MemoryBlock& destData)
 {
 	MemoryOutputStream stream(destData, true);
 
-	String ip = GetIpAddress();
+	// The IP address field refers to the first device. The rest of the device table is appended further below.
+	StringArray deviceIpAddresses;
+	CController* ctrl = CController::GetInstance();
+	if (ctrl)
+	{
+		for (DeviceId deviceId = 0; deviceId < CController::DEVICE_COUNT_MAX; ++deviceId)
+			deviceIpAddresses.add(ctrl->GetIpAddress(deviceId));
+	}
+
+	String ip = deviceIpAddresses[0];
 	CVersion version(String(JUCE_STRINGIFY(JUCE_APP_VERSION)));
 	jassert(version.IsValid());
 	stream.writeInt(version.ToInt());
@@ -383,6 +699,10 @@ void CPlugin::getStateInformation(MemoryBlock& destData)
 	stream.writeInt(overviewBounds.getWidth());
 	stream.writeInt(overviewBounds.getHeight());
 	stream.writeInt(m_pluginId);
+	stream.writeInt(GetDeviceId());
+	stream.writeInt(deviceIpAddresses.size());
+	for (int i = 0; i < deviceIpAddresses.size(); ++i)
+		stream.writeString(deviceIpAddresses[i]);
 
 #ifdef DB_SHOW_DEBUG
 	PushDebugMessage(String::formatted("CPlugin::getStateInformation, pId=%d, sId=%d >>", m_pluginId, GetSourceId()));
@@ -429,6 +749,17 @@ void CPlugin::setStateInformation(const void* data, int sizeInBytes)
 			pluginId = stream.readInt();
 		}
 
+		// DeviceId and device table were added in V2.9.0
+		DeviceId deviceId = 0;
+		StringArray deviceIpAddresses;
+		if (version >= CVersion(2, 9))
+		{
+			deviceId = stream.readInt();
+			int numDevices = stream.readInt();
+			for (int i = 0; (i < numDevices) && !stream.isExhausted(); ++i)
+				deviceIpAddresses.add(stream.readString());
+		}
+
 		// NOTE: Special workaround for Pro Tools no longer needed since 
 		// the introduction of the JucePlugin_AAXDisableDefaultSettingsChunks flag.
 
@@ -436,7 +767,7 @@ void CPlugin::setStateInformation(const void* data, int sizeInBytes)
 		PushDebugMessage(String::formatted("CPlugin::setStateInformation: pId=%d, sId=%d <<", pluginId, sourceId));
 #endif
 
-		InitializeSettings(sourceId, mapId, ipAddress, msgRate, newComMode);
+		InitializeSettings(sourceId, mapId, ipAddress, msgRate, newComMode, deviceId, deviceIpAddresses);
 
 		SetParameterValue(DCS_Host, ParamIdx_X, xPos);
 		SetParameterValue(DCS_Host, ParamIdx_Y, yPos);
@@ -467,10 +798,10 @@ void CPlugin::setStateInformation(const void* data, int sizeInBytes)
  */
 void CPlugin::SetComsMode(DataChangeSource changeSource, ComsMode newMode)
 {
-	if (m_comsMode != newMode)
+	// Exchange in one step, so that concurrent changes, i.e. SetMappingId() adding CM_PollOnce, are not lost unnoticed.
+	ComsMode oldMode = m_comsMode.exchange(newMode);
+	if (oldMode != newMode)
 	{
-		m_comsMode = newMode;
-
 		// Backup last non-bypass mode.
 		if (newMode != CM_Off)
 			m_comsModeWhenNotBypassed = newMode;
@@ -478,11 +809,14 @@ void CPlugin::SetComsMode(DataChangeSource changeSource, ComsMode newMode)
 		// Reset response-ignoring mechanism.
 		m_paramSetCommandsInTransit = DCT_None;
 
+		// Start polling at full rate again.
+		ResetPollIntervals();
+
 		// Signal change to other modules in the plugin.
 		SetParameterChanged(changeSource, DCT_ComsMode);
 
 		// If either CM_Rx or CM_Tx flags are set, bypass is off.
-		float bypassValue = ((m_comsMode & CM_Sync) == 0) ? 1.0f : 0.0f;
+		float bypassValue = ((newMode & CM_Sync) == 0) ? 1.0f : 0.0f;
 		SetParameterValue(changeSource, ParamIdx_Bypass, bypassValue);
 	}
 }
@@ -493,8 +827,21 @@ void CPlugin::SetComsMode(DataChangeSource changeSource, ComsMode newMode)
  */
 void CPlugin::RestoreComsMode(DataChangeSource changeSource)
 {
-	if (m_comsModeWhenNotBypassed != CM_Off)
-		SetComsMode(changeSource, m_comsModeWhenNotBypassed);
+	ComsMode modeWhenNotBypassed = m_comsModeWhenNotBypassed;
+	if (modeWhenNotBypassed != CM_Off)
+		SetComsMode(changeSource, modeWhenNotBypassed);
+}
+
+/**
+ * Leave CM_PollOnce mode, once the response to the request which was sent because of it has been applied.
+ * Other bits of the OSC communication mode are left alone, even if they are being changed concurrently.
+ * @param changeSource	The application module which is causing the property change.
+ */
+void CPlugin::ClearPollOnce(DataChangeSource changeSource)
+{
+	ComsMode oldMode = m_comsMode.fetch_and(static_cast<ComsMode>(~CM_PollOnce));
+	if ((oldMode & CM_PollOnce) == CM_PollOnce)
+		SetParameterChanged(changeSource, DCT_ComsMode);
 }
 
 /**
@@ -518,6 +865,8 @@ void CPlugin::SetMappingId(DataChangeSource changeSource, int mappingId)
 		DataChangeTypes dct = DCT_MappingID;
 
 		m_mappingId = mappingId;
+		m_oscAddressCacheStale = true;
+		ResetPollIntervals();
 
 		// If the user changes the coodinate mapping and we are in Receive mode, then the position
 		// of the X/Y sliders will update automatically to reflect the new mapping in the DS100.
@@ -525,7 +874,7 @@ void CPlugin::SetMappingId(DataChangeSource changeSource, int mappingId)
 		if ((GetComsMode() & CM_Rx) != CM_Rx)
 		{
 			dct |= DCT_ComsMode;
-			m_comsMode |= CM_PollOnce;
+			m_comsMode.fetch_or(CM_PollOnce);
 		}
 
 		// Signal change to other modules in the plugin.
@@ -549,6 +898,20 @@ int CPlugin::GetMappingId() const
 	return m_mappingId;
 }
 
+/**
+ * Getter function for the pre-encoded OSC address patterns of this Plug-in instance.
+ * The cache is rebuilt here if the SourceID or MappingID has changed since it was last used, so that it is only 
+ * ever written by the thread which reads it. Must only be called while holding the CController's send lock.
+ * @return	The address cache, up to date with the current SourceID and MappingID.
+ */
+const COscAddressCache& CPlugin::GetOscAddressCache()
+{
+	if (m_oscAddressCacheStale.exchange(false))
+		m_oscAddressCache.Update(m_mappingId, m_sourceId);
+
+	return m_oscAddressCache;
+}
+
 /**
  * Setter function for the source Id
  * @param changeSource	The application module which is causing the property change.
@@ -559,11 +922,19 @@ void CPlugin::SetSourceId(DataChangeSource changeSource, SourceId sourceId)
 	if (m_sourceId != sourceId)
 	{
 #ifdef DB_SHOW_DEBUG
-		PushDebugMessage("CPlugin::SetSourceId " + String(m_sourceId) + String(" to ") + String(jmin(SOURCE_ID_MAX, jmax(SOURCE_ID_MIN, sourceId))));
+		PushDebugMessage("CPlugin::SetSourceId " + String(m_sourceId.load()) + String(" to ") + String(jmin(SOURCE_ID_MAX, jmax(SOURCE_ID_MIN, sourceId))));
 #endif
 
 		// Ensure it's within allowed range.
+		SourceId oldSourceId = m_sourceId;
 		m_sourceId = jmin(SOURCE_ID_MAX, jmax(SOURCE_ID_MIN, sourceId));
+		m_oscAddressCacheStale = true;
+		ResetPollIntervals();
+
+		// Received values are routed by SourceId.
+		CController* ctrl = CController::GetInstance();
+		if (ctrl)
+			ctrl->UpdateSourceRoute(this, m_deviceId, oldSourceId);
 
 		// Signal change to other modules in the plugin.
 		SetParameterChanged(changeSource, DCT_SourceID);
@@ -577,6 +948,15 @@ void CPlugin::SetSourceId(DataChangeSource changeSource, SourceId sourceId)
 	}
 }
 
+/**
+ * Getter function for the Plug-in's ID.
+ * @return	The PluginId assigned by CController::AddProcessor(), or -1 if not registered.
+ */
+PluginId CPlugin::GetPluginId() const
+{
+	return m_pluginId;
+}
+
 /**
  * Getter function for the source Id
  * @return	The current source ID
@@ -587,7 +967,53 @@ SourceId CPlugin::GetSourceId() const
 }
 
 /**
- * Setter function for the IP address for outgoing OSC comnmunication.
+ * Setter function for the device Id
+ * @param changeSource	The application module which is causing the property change.
+ * @param deviceId	Index of the DS100 within the CController's device table.
+ */
+void CPlugin::SetDeviceId(DataChangeSource changeSource, DeviceId deviceId)
+{
+	// Ensure it's within allowed range.
+	deviceId = jmin(CController::DEVICE_COUNT_MAX - 1, jmax(0, deviceId));
+
+	if (m_deviceId != deviceId)
+	{
+		DeviceId oldDeviceId = m_deviceId;
+		m_deviceId = deviceId;
+
+		// Received values are routed by device.
+		CController* ctrl = CController::GetInstance();
+		if (ctrl)
+			ctrl->UpdateSourceRoute(this, oldDeviceId, m_sourceId);
+
+		// Reset response-ignoring mechanism, and start polling the new device at full rate.
+		m_paramSetCommandsInTransit = DCT_None;
+		ResetPollIntervals();
+
+		// Signal change to other modules in the plugin. IP address and Online status
+		// depend on the device, so these need to be updated on the GUI as well.
+		SetParameterChanged(changeSource, (DCT_DeviceID | DCT_IPAddress | DCT_Online));
+
+		// Since deviceID is not registered as an AudioProcessorParameter, we need to force the host
+		// to call getStateInformation, otherwise we may save a project file or snapshot with an outdated deviceID.
+		if (changeSource == DCS_Gui)
+		{
+			updateHostDisplay();
+		}
+	}
+}
+
+/**
+ * Getter function for the device Id
+ * @return	Index of the DS100 within the CController's device table.
+ */
+DeviceId CPlugin::GetDeviceId() const
+{
+	return m_deviceId;
+}
+
+/**
+ * Setter function for the IP address of the DS100 to which this Plug-in is bound.
  * @param changeSource	The application module which is causing the property change.
  * @param ipAddress	The new IP address as a string
  */
@@ -595,11 +1021,11 @@ void CPlugin::SetIpAddress(DataChangeSource changeSource, String ipAddress)
 {
 	CController* ctrl = CController::GetInstance();
 	if (ctrl)
-		ctrl->SetIpAddress(changeSource, ipAddress);
+		ctrl->SetIpAddress(changeSource, ipAddress, GetDeviceId());
 }
 
 /**
-* Getter function for the IP address
+* Getter function for the IP address of the DS100 to which this Plug-in is bound.
 * @return	The current IP address as a string
 */
 String CPlugin::GetIpAddress() const
@@ -607,7 +1033,7 @@ String CPlugin::GetIpAddress() const
 	String ipAddress;
 	CController* ctrl = CController::GetInstance();
 	if (ctrl)
-		ipAddress = ctrl->GetIpAddress();
+		ipAddress = ctrl->GetIpAddress(GetDeviceId());
 
 	return ipAddress;
 }
@@ -639,14 +1065,14 @@ int CPlugin::GetMessageRate() const
 }
 
 /**
- * Getter function for the last OSCSender connection status.
- * @return	True if the last message attempted by the OSCSender was successful, false if it failed.
+ * Getter function for the connection status of the DS100 to which this Plug-in is bound.
+ * @return	True if the DS100 has responded recently, false if it has not.
  */
 bool CPlugin::GetOnline() const
 {
 	CController* ctrl = CController::GetInstance();
 	if (ctrl)
-		return ctrl->GetOnline();
+		return ctrl->GetOnline(GetDeviceId());
 
 	return false;
 }
@@ -658,21 +1084,27 @@ bool CPlugin::GetOnline() const
  * @param ipAddress		New IP address of the DS100 device.
  * @param oscMsgRate	New interval for OSC messages, in milliseconds.
  * @param newMode		New OSC communication mode (Rx/Tx).
+ * @param deviceId		New DS100 device to which this plugin instance is bound.
+ * @param deviceIpAddresses	IP addresses of all DS100 devices, starting with the first one. May be empty.
  */
-void CPlugin::InitializeSettings(int sourceId, int mappingId, String ipAddress, int oscMsgRate, ComsMode newMode)
+void CPlugin::InitializeSettings(int sourceId, int mappingId, String ipAddress, int oscMsgRate, ComsMode newMode, DeviceId deviceId, const StringArray& deviceIpAddresses)
 {
 	CController* ctrl = CController::GetInstance();
 	if (ctrl)
 	{
+		SetDeviceId(DCS_Host, deviceId);
 		SetSourceId(DCS_Host, sourceId);
 		SetMappingId(DCS_Host, mappingId);
 		SetComsMode(DCS_Host, newMode);
 
 		// Only overwite the current IP settings if they haven't been changed from the defaults.
-		if (GetIpAddress() == ctrl->GetDefaultIpAddress())
+		if (ctrl->GetIpAddress() == ctrl->GetDefaultIpAddress())
 		{
 			ctrl->InitGlobalSettings(DCS_Host, ipAddress, oscMsgRate);
 		}
+
+		// Likewise, only devices which are still unused are taken over from the device table.
+		ctrl->InitDeviceTable(DCS_Host, deviceIpAddresses);
 	}
 }
 
@@ -774,6 +1206,10 @@ bool CPlugin::IsTargetHostAvidConsole() const
  * The host will call this method AFTER one of the filter's parameters has been changed.
  * The host may call this at any time, even when a parameter's value isn't actually being changed, 
  * including during the audio processing callback (avoid blocking!).
+ * Therefore, nothing on this path may lock or allocate: the parameter getters and SetParameterChanged() 
+ * only use atomics, and host changes are passed on to the GUIs by the CController's timer thread.
+ * NOTE: The parameter's own listener notification, which calls this method, takes JUCE's listener lock. 
+ * See CRealtimeTest in the unit tests, which checks this method and reports the locks around it.
  * @param parameterIndex	Index of the plugin parameter being changed.
  * @param newValue			New parameter value, always between 0.0f and 1.0f.
  */
@@ -829,8 +1265,8 @@ void CPlugin::parameterValueChanged(int parameterIndex, float newValue)
 	if (changed != DCT_None)
 	{
 		// To ensure that this property change is registered with the correct source, 
-		// m_currentChangeSource is set properly inside SetParameterValue
-		SetParameterChanged(m_currentChangeSource, changed);
+		// the source is registered for this thread inside SetParameterValue
+		SetParameterChanged(GetChangeSource(), changed);
 	}
 }
 
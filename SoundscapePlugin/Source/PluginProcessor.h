@@ -36,6 +36,8 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
 #include "Common.h"
+#include "OscCodec.h"
+#include <atomic>
 
 
 namespace dbaudio
@@ -70,14 +72,21 @@ public:
 	CPlugin();
 	~CPlugin() override;
 
-	void InitializeSettings(SourceId sourceId, int mappingId, String ipAddress, int oscMsgRate, ComsMode newMode);
+	void InitializeSettings(SourceId sourceId, int mappingId, String ipAddress, int oscMsgRate, ComsMode newMode, DeviceId deviceId, const StringArray& deviceIpAddresses);
+
+	PluginId GetPluginId() const;
 
 	SourceId GetSourceId() const;
 	void SetSourceId(DataChangeSource changeSource, SourceId sourceId);
 
+	DeviceId GetDeviceId() const;
+	void SetDeviceId(DataChangeSource changeSource, DeviceId deviceId);
+
 	int GetMappingId() const;
 	void SetMappingId(DataChangeSource changeSource, int mappingId);
 
+	const COscAddressCache& GetOscAddressCache();
+
 	String GetIpAddress() const;
 	void SetIpAddress(DataChangeSource changeSource, String ipAddress);
 
@@ -96,9 +105,22 @@ public:
 	bool GetParameterChanged(DataChangeSource changeSource, DataChangeTypes change);
 	bool PopParameterChanged(DataChangeSource changeSource, DataChangeTypes change);
 	void SetParameterChanged(DataChangeSource changeSource, DataChangeTypes changeTypes);
-
-	void Tick();
+	DataChangeTypes PopPendingNotifications();
+
+	bool MarkQueued(ProcessorQueue queue);
+	void ClearQueued(ProcessorQueue queue);
+	CPlugin* GetNextQueued(ProcessorQueue queue) const;
+	void SetNextQueued(ProcessorQueue queue, CPlugin* next);
+	uint32 GetLastSetTime() const;
+	void SetLastSetTime(uint32 time);
+	bool IsPollDue(OscCommand command, uint32 now);
+	int GetPollInterval(OscCommand command);
+	void SetPollSent(OscCommand command, uint32 now);
+	void SetPollActivity(OscCommand command, bool valueChanged);
+	void ResetPollIntervals();
+	void ClearPollOnce(DataChangeSource changeSource);
 	void SetParamInTransit(DataChangeTypes paramsChanged);
+	void ClearParamInTransit();
 	bool IsParamInTransit(DataChangeTypes paramsChanged) const;
 
 	void OnOverviewButtonClicked();
@@ -145,6 +167,13 @@ public:
 #endif
 
 protected:
+	int PushChangeSource(DataChangeSource changeSource, DataChangeSource& previousSource);
+	void PopChangeSource(int slot, DataChangeSource previousSource);
+	DataChangeSource GetChangeSource() const;
+	void ApplyPendingPollReset();
+	void ApplyPendingPollActivity();
+	void UpdatePollInterval(int command, bool valueChanged, uint32 now);
+
 	/**
 	 * X coordinate in meters.
 	 * NOTE: not using std::unique_ptr here, see addParameter().
@@ -177,44 +206,115 @@ protected:
 	CAudioParameterChoice*		m_bypassParam;
 
 	/**
-	 * Current OSC communication mode, sending and/or receiving.
+	 * Current OSC communication mode, sending and/or receiving. Atomic, since it is changed by the message thread 
+	 * (i.e. SetMappingId() adds CM_PollOnce), by the CController's timer thread (Bypass), and by the host.
 	 */
-	ComsMode					m_comsMode;
+	std::atomic<ComsMode>		m_comsMode;
 
 	/**
 	 * Previous OSC communication mode, before going into Bypass.
 	 */
-	ComsMode					m_comsModeWhenNotBypassed;
+	std::atomic<ComsMode>		m_comsModeWhenNotBypassed;
 
 	/*
 	 * Coordinate mapping index (1 to 4).
 	 */
-	int							m_mappingId;
+	std::atomic<int>			m_mappingId;
 
 	/*
 	 * SourceID, or matrix input number.
 	 */
-	SourceId					m_sourceId;
+	std::atomic<SourceId>		m_sourceId;
 
 	/**
-	 * Unique ID of this Plug-in instance. 
-	 * This is also this Plug-in's index within the CController::m_processors array.
+	 * Index of the DS100 within the CController's device table, to which this Plug-in's SourceID refers.
+	 * Atomic for the same reason as m_sourceId.
+	 */
+	std::atomic<DeviceId>		m_deviceId;
+
+	/**
+	 * Pre-encoded OSC address patterns for this Plug-in's SourceID and MappingID.
+	 * Only accessed by the thread which sends OSC messages, see GetOscAddressCache().
+	 */
+	COscAddressCache			m_oscAddressCache;
+
+	/**
+	 * Set by SetSourceId() and SetMappingId(), so that m_oscAddressCache is rebuilt before it is next used.
+	 */
+	std::atomic<bool>			m_oscAddressCacheStale;
+
+	/**
+	 * Unique ID of this Plug-in instance, as returned by CController::AddProcessor().
+	 * It does not change while this Plug-in is registered, see CController::GetProcessorById().
 	 */
 	PluginId					m_pluginId;
 
 	/**
 	 * Keep track of which automation parameters have changed recently. 
 	 * The array has one entry for each application module (see enum DataChangeSource).
+	 * The flags are atomic, since they are set and popped from the host's automation thread, 
+	 * the message thread and the CController's timer thread.
+	 */
+	std::atomic<DataChangeTypes>	m_parametersChanged[DCS_Max];
+
+	/**
+	 * Changes made by the host which the GUIs have not been woken for yet. These are published from the host's
+	 * audio thread and passed on by the CController's timer thread, see PopPendingNotifications().
 	 */
-	DataChangeTypes				m_parametersChanged[DCS_Max];
+	std::atomic<DataChangeTypes>	m_pendingNotifications;
 
 	/**
 	 * Flags used to indicate when a SET command for a parameter is currently out on the network.
-	 * Until such a flag is cleared (in the Tick() method), calls to IsParamInTransit will return true.
+	 * Until such a flag is cleared (see ClearParamInTransit()), calls to IsParamInTransit will return true.
 	 * This mechanism is used to ensure that parameters aren't overwritten right after having been
-	 * changed via the Gui or the host.
+	 * changed via the Gui or the host. Set by the threads which send SET commands, and cleared by the
+	 * CController's timer thread and the message thread.
+	 */
+	std::atomic<DataChangeTypes>	m_paramSetCommandsInTransit;
+
+	/**
+	 * Set by ResetPollIntervals(), so that the poll state below is reset before it is next used. The poll state
+	 * itself is only accessed by the thread which sends OSC messages, while holding the CController's send lock.
+	 */
+	std::atomic<bool>			m_pollResetPending;
+
+	/**
+	 * Activity reported by SetPollActivity() since the poll state was last accessed, two bits per OscCommand
+	 * (see POLL_ACTIVITY_BITS). Applied to the poll state by the thread which sends OSC messages.
 	 */
-	DataChangeTypes				m_paramSetCommandsInTransit = DCT_None;
+	std::atomic<uint32>			m_pollActivity;
+
+	/**
+	 * Current interval between GET commands for each OscCommand, in milliseconds. This grows exponentially
+	 * while a parameter's value stays the same, and snaps back to the minimum once it changes. See SetPollActivity().
+	 */
+	int							m_pollInterval[OscCmd_MaxIndex];
+
+	/**
+	 * Time at which the next GET command is due for each OscCommand. See Time::getMillisecondCounter().
+	 */
+	uint32						m_nextPollTime[OscCmd_MaxIndex];
+
+	/**
+	 * Time at which each OscCommand's value last changed, either on the DS100 or locally.
+	 */
+	uint32						m_lastPollChangeTime[OscCmd_MaxIndex];
+
+	/**
+	 * True while this instance is on the corresponding list of Plug-ins which the CController needs to visit.
+	 * See MarkQueued() and CController::QueueProcessorForTick().
+	 */
+	std::atomic<bool>			m_queued[PQ_Max];
+
+	/**
+	 * Next Plug-in on each of the CController's lists. Only valid while the corresponding m_queued flag is set.
+	 */
+	CPlugin*					m_nextQueued[PQ_Max];
+
+	/**
+	 * Time at which SET commands were last sent out over the low-latency path. See Time::getMillisecondCounter().
+	 */
+	uint32						m_lastSetTime = 0;
 
 	/**
 	 * Name of this Plug-in instance. Some hosts (i.e. VST3) which support updateTrackProperties(..) 
@@ -224,10 +324,26 @@ protected:
 	String						m_pluginDisplayName;
 
 	/**
-	 * Member used to ensure that property changes are registered to the correct source.
-	 * See CPlugin::SetParameterValue().
+	 * Number of threads which may be inside SetParameterValue() at the same time, see m_changeSources.
+	 */
+	static constexpr int CHANGE_SOURCE_SLOTS = 4;
+
+	/**
+	 * Source of a parameter change which a thread is currently making through SetParameterValue().
+	 */
+	struct ChangeSourceSlot
+	{
+		std::atomic<Thread::ThreadID>	thread;
+		DataChangeSource				source;
+	};
+
+	/**
+	 * Members used to ensure that property changes are registered to the correct source. See SetParameterValue().
+	 * parameterValueChanged() is called on the thread which made the change, and looks up that thread here. 
+	 * Changes from threads which are not found are the host's. One slot per thread, since the GUI and the host 
+	 * may change parameters concurrently.
 	 */
-	DataChangeSource			m_currentChangeSource = DCS_Host;
+	ChangeSourceSlot			m_changeSources[CHANGE_SOURCE_SLOTS];
 
 #ifdef DB_SHOW_DEBUG
 	/**
@@ -289,7 +289,7 @@ void CSurfaceMultiSlider::mouseDown(const MouseEvent& e)
 			CController* ctrl = CController::GetInstance();
 			if (ctrl)
 			{
-				CPlugin* plugin = ctrl->GetProcessor(m_selected);
+				CPlugin* plugin = ctrl->GetProcessorById(m_selected);
 				jassert(plugin);
 				if (plugin)
 				{
@@ -319,7 +319,7 @@ void CSurfaceMultiSlider::mouseDrag(const MouseEvent& e)
 		CController* ctrl = CController::GetInstance();
 		if (ctrl)
 		{
-			CPlugin* plugin = ctrl->GetProcessor(m_selected);
+			CPlugin* plugin = ctrl->GetProcessorById(m_selected);
 			if (plugin)
 			{
 				// Get mouse pixel-wise position and scale it between 0 and 1.
@@ -348,7 +348,7 @@ void CSurfaceMultiSlider::mouseUp(const MouseEvent& e)
 		CController* ctrl = CController::GetInstance();
 		if (ctrl)
 		{
-			CPlugin* plugin = ctrl->GetProcessor(m_selected);
+			CPlugin* plugin = ctrl->GetProcessorById(m_selected);
 			if (plugin)
 			{
 				dynamic_cast<CAudioParameterFloat*>(plugin->getParameters()[ParamIdx_X])->EndGuiGesture();
@@ -0,0 +1,173 @@
+/*
+===============================================================================
+
+Copyright (C) 2019 d&b audiotechnik GmbH & Co. KG. All Rights Reserved.
+
+This file is part of the Soundscape VST, AU, and AAX Plug-in.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY d&b audiotechnik GmbH & Co. KG "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+===============================================================================
+*/
+
+
+#include "../../Source/Controller.h"
+#include "../../Source/PluginProcessor.h"
+
+#include <thread>
+#include <vector>
+
+
+namespace dbaudio
+{
+
+
+/**
+ * Number of changes flagged by each producer thread of the stress test.
+ */
+static constexpr int STRESS_CHANGE_COUNT = 100000;
+
+/**
+ * Milliseconds after which a producer gives up waiting for its change to be popped, i.e. considers it lost.
+ */
+static constexpr int STRESS_TIMEOUT = 10000;
+
+
+/**
+ * Class CChangeFlagsTest flags changes from several threads at once, while another thread pops them, 
+ * as the GUI, the host and the CController's timer do. Each producer owns one flag, and only flags its 
+ * next change once the previous one was popped. A change which is lost therefore makes its producer time out.
+ */
+class CChangeFlagsTest : public UnitTest
+{
+public:
+	CChangeFlagsTest()
+		: UnitTest("Change flags", "Soundscape")
+	{
+	}
+
+	void runTest() override
+	{
+		beginTest("Concurrent CPlugin::SetParameterChanged() and PopParameterChanged() calls lose no flags");
+		{
+			CPlugin plugin;
+			RunStressTest(plugin, { DCS_Gui, DCS_Gui, DCS_Host, DCS_Osc }, { DCT_SourceID, DCT_MappingID, DCT_ComsMode, DCT_DeviceID });
+		}
+
+		beginTest("Concurrent CController::SetParameterChanged() and PopParameterChanged() calls lose no flags");
+		{
+			// Only global settings which the timer tick does not flag by itself. 
+			// The Plug-in keeps the CController alive meanwhile.
+			CPlugin plugin;
+			CController* ctrl = CController::GetInstance();
+			RunStressTest(*ctrl, { DCS_Gui, DCS_Host, DCS_Osc }, { DCT_NumPlugins, DCT_IPAddress, DCT_MessageRate });
+		}
+	}
+
+private:
+	/**
+	 * Run one producer thread per flag against a consumer thread, which pops the flags for DCS_Gui.
+	 * @param target	The CPlugin or CController whose flags are tested.
+	 * @param sources	For each producer, the DataChangeSource it flags its changes with.
+	 * @param flags		For each producer, the flag it owns.
+	 */
+	template <typename Target>
+	void RunStressTest(Target& target, const std::vector<DataChangeSource>& sources, const std::vector<DataChangeTypes>& flags)
+	{
+		jassert(sources.size() == flags.size());
+		const int numProducers = static_cast<int>(flags.size());
+
+		std::vector<std::atomic<bool>> pending(flags.size());
+		std::vector<int> changesPopped(flags.size(), 0);
+		std::vector<int> changesLost(flags.size(), 0);
+		std::atomic<int> producersRunning(numProducers);
+
+		// Start without leftovers from creating the target.
+		for (DataChangeTypes flag : flags)
+			target.PopParameterChanged(DCS_Gui, flag);
+		for (std::atomic<bool>& p : pending)
+			p = false;
+
+		std::vector<std::thread> producers;
+		double start = Time::getMillisecondCounterHiRes();
+		for (int i = 0; i < numProducers; ++i)
+		{
+			producers.emplace_back([&, i]
+			{
+				for (int change = 0; change < STRESS_CHANGE_COUNT; ++change)
+				{
+					pending[i] = true;
+					target.SetParameterChanged(sources[i], flags[i]);
+
+					uint32 deadline = Time::getMillisecondCounter() + STRESS_TIMEOUT;
+					while (pending[i] && (Time::getMillisecondCounter() < deadline))
+						std::this_thread::yield();
+
+					if (pending[i])
+					{
+						changesLost[i]++;
+						break;
+					}
+				}
+				producersRunning--;
+			});
+		}
+
+		std::thread consumer([&]
+		{
+			while (producersRunning > 0)
+			{
+				for (int i = 0; i < numProducers; ++i)
+				{
+					if (target.PopParameterChanged(DCS_Gui, flags[i]) && pending[i])
+					{
+						changesPopped[i]++;
+						pending[i] = false;
+					}
+				}
+
+				// Let the producers run on machines with few cores.
+				std::this_thread::yield();
+			}
+		});
+
+		for (std::thread& producer : producers)
+			producer.join();
+		consumer.join();
+		double elapsed = Time::getMillisecondCounterHiRes() - start;
+
+		for (int i = 0; i < numProducers; ++i)
+		{
+			expectEquals(changesLost[i], 0, "Flag " + String::toHexString(static_cast<int>(flags[i])) + " was lost");
+			expectEquals(changesPopped[i], STRESS_CHANGE_COUNT);
+		}
+		logMessage(String(numProducers * STRESS_CHANGE_COUNT) + " changes flagged and popped in " + String(elapsed, 0) + " ms");
+	}
+};
+
+static CChangeFlagsTest changeFlagsTest;
+
+
+} // namespace dbaudio
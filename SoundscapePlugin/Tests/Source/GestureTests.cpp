@@ -0,0 +1,212 @@
+/*
+===============================================================================
+
+Copyright (C) 2019 d&b audiotechnik GmbH & Co. KG. All Rights Reserved.
+
+This file is part of the Soundscape VST, AU, and AAX Plug-in.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY d&b audiotechnik GmbH & Co. KG "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+===============================================================================
+*/
+
+
+
+#include "../../Source/Parameters.h"
+
+#include <thread>
+#include <vector>
+
+
+namespace dbaudio
+{
+
+
+/**
+ * Number of parameters, and threads changing them, used by the contention test.
+ */
+static constexpr int GESTURE_PARAMETER_COUNT = 64;
+static constexpr int GESTURE_THREAD_COUNT = 2;
+
+/**
+ * Longest pause between two bursts of changes of each thread, in milliseconds. Chosen so that the same 
+ * parameter is changed about once per GESTURE_TIMEOUT, i.e. its gesture often ends just as it is changed again.
+ */
+static constexpr int GESTURE_PAUSE_MAX = 24;
+
+/**
+ * Milliseconds during which the parameters are changed by the contention test.
+ */
+static constexpr int GESTURE_TEST_DURATION = 3000;
+
+
+/**
+ * Class CTestGestureParameter counts the gestures which the AGestureParameter base class begins and ends,
+ * and whether they alternate properly.
+ */
+class CTestGestureParameter : public AGestureParameter
+{
+public:
+	CTestGestureParameter()
+		: m_open(0),
+		m_begins(0),
+		m_ends(0),
+		m_violations(0)
+	{
+	}
+
+	~CTestGestureParameter() override
+	{
+		CancelGesture();
+	}
+
+	/**
+	 * Signal a value change, as the parameter classes do for changes from OSC or the host.
+	 */
+	void Change()
+	{
+		ChangeOccurred();
+	}
+
+	int GetBeginCount() const { return m_begins; }
+	int GetEndCount() const { return m_ends; }
+	int GetViolationCount() const { return m_violations; }
+
+protected:
+	void BeginGesture() override
+	{
+		m_begins++;
+		if (m_open.fetch_add(1) != 0)
+			m_violations++;
+	}
+
+	void EndGesture() override
+	{
+		m_ends++;
+		if (m_open.fetch_sub(1) != 1)
+			m_violations++;
+	}
+
+private:
+	/**
+	 * Number of gestures which have begun but not yet ended. Only ever 0 or 1 if begins and ends alternate.
+	 */
+	std::atomic<int> m_open;
+
+	/**
+	 * Number of BeginGesture() and EndGesture() calls, and of calls which did not alternate.
+	 */
+	std::atomic<int> m_begins;
+	std::atomic<int> m_ends;
+	std::atomic<int> m_violations;
+};
+
+
+/**
+ * Class CGestureManagerTest changes parameters from several threads while another thread advances the 
+ * CGestureManager, as the host, the OSC receive path and the CController's timer do. Each parameter is changed
+ * in bursts about once per GESTURE_TIMEOUT, so that many changes race with their gesture being ended.
+ * Every begun gesture must be ended exactly once.
+ */
+class CGestureManagerTest : public UnitTest
+{
+public:
+	CGestureManagerTest()
+		: UnitTest("CGestureManager", "Soundscape")
+	{
+	}
+
+	void runTest() override
+	{
+		beginTest("Gestures begun from several threads are ended exactly once");
+
+		OwnedArray<CTestGestureParameter> parameters;
+		for (int i = 0; i < GESTURE_PARAMETER_COUNT; ++i)
+			parameters.add(new CTestGestureParameter());
+
+		std::atomic<bool> changing(true);
+		std::atomic<bool> advancing(true);
+		std::atomic<int> changeCount(0);
+		std::atomic<int> advanceCount(0);
+
+		std::thread ticker([&]
+		{
+			while (advancing)
+			{
+				CGestureManager::GetInstance().Advance(Time::getMillisecondCounter());
+				advanceCount++;
+				Thread::sleep(1);
+			}
+		});
+
+		std::vector<std::thread> changers;
+		for (int t = 0; t < GESTURE_THREAD_COUNT; ++t)
+		{
+			changers.emplace_back([&, t]
+			{
+				Random random(t + 1);
+				while (changing)
+				{
+					// A burst of changes to a random parameter.
+					CTestGestureParameter* parameter = parameters[random.nextInt(GESTURE_PARAMETER_COUNT)];
+					int burst = 1 + random.nextInt(100);
+					for (int i = 0; i < burst; ++i)
+						parameter->Change();
+					changeCount += burst;
+
+					Thread::sleep(random.nextInt(GESTURE_PAUSE_MAX));
+				}
+			});
+		}
+
+		Thread::sleep(GESTURE_TEST_DURATION);
+		changing = false;
+		for (std::thread& changer : changers)
+			changer.join();
+
+		// Let all remaining gestures time out. They must end within a few slots of the timer wheel after their timeout.
+		Thread::sleep(CGestureManager::GESTURE_TIMEOUT + 100);
+		advancing = false;
+		ticker.join();
+
+		int begins = 0;
+		for (CTestGestureParameter* parameter : parameters)
+		{
+			expect(!parameter->IsGestureRunning());
+			expectEquals(parameter->GetViolationCount(), 0);
+			expectEquals(parameter->GetEndCount(), parameter->GetBeginCount());
+			begins += parameter->GetBeginCount();
+		}
+		expect(begins > GESTURE_PARAMETER_COUNT);
+
+		logMessage(String(changeCount.load()) + " changes, " + String(begins) + " gestures and " + String(advanceCount.load()) + 
+			" Advance() calls in " + String(GESTURE_TEST_DURATION) + " ms");
+	}
+};
+
+static CGestureManagerTest gestureManagerTest;
+
+
+} // namespace dbaudio
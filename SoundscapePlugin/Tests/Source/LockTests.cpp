@@ -0,0 +1,154 @@
+/*
+===============================================================================
+
+Copyright (C) 2019 d&b audiotechnik GmbH & Co. KG. All Rights Reserved.
+
+This file is part of the Soundscape VST, AU, and AAX Plug-in.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY d&b audiotechnik GmbH & Co. KG "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+===============================================================================
+*/
+
+
+
+#include "RealtimeCheck.h"
+#include "../../Source/Controller.h"
+#include "../../Source/PluginProcessor.h"
+
+
+namespace dbaudio
+{
+
+
+/**
+ * Milliseconds during which the message thread's getters are called while the timer tick runs.
+ */
+static constexpr int LOCK_TEST_DURATION = 1000;
+
+
+/**
+ * Class CLockTest measures how long the message thread waits in the CController's getters while the timer tick
+ * is running, and checks that those getters never take the lock which the tick holds, see CController::LD_Send.
+ * The lock statistics of both domains are reported along with it, see CController::GetLockProfile().
+ */
+class CLockTest : public UnitTest
+{
+public:
+	CLockTest()
+		: UnitTest("Locks", "Soundscape")
+	{
+	}
+
+	void runTest() override
+	{
+		CPlugin plugin;
+		CController* ctrl = CController::GetInstance();
+
+		// Keep the tick busy: poll at the fastest rate, so that the Plug-in is visited on every tick.
+		int previousRate = ctrl->GetRate();
+		ctrl->SetRate(DCS_Gui, CController::GetSupportedRateRange().first);
+		plugin.SetComsMode(DCS_Gui, CM_Sync);
+		ctrl->ResetLockProfiles();
+
+		beginTest("The message thread's getters do not wait for the timer tick");
+		{
+			int calls = 0;
+			int locks = 0;
+			double waitMax = 0.0;
+			double ipAddressWaitMax = 0.0;
+
+			const uint32 end = Time::getMillisecondCounter() + LOCK_TEST_DURATION;
+			while (static_cast<int>(end - Time::getMillisecondCounter()) > 0)
+			{
+				// What the GUIs show of the CController's state on every update. See COverviewComponent::UpdateGui().
+				int64 start = Time::getHighResolutionTicks();
+				{
+					CRealtimeCheck check;
+					bool online = ctrl->GetOnline();
+					int rate = ctrl->GetRate();
+					int refreshInterval = ctrl->GetPollRefreshInterval();
+					int packets = ctrl->GetTxPacketsPerTick();
+					ignoreUnused(online, rate, refreshInterval, packets);
+					locks += check.GetLockCount();
+				}
+				waitMax = jmax(waitMax, ElapsedMicroseconds(start));
+
+				// The IP address is a String, which is guarded by the registry lock instead. The tick does not take it.
+				start = Time::getHighResolutionTicks();
+				String ipAddress = ctrl->GetIpAddress();
+				ipAddressWaitMax = jmax(ipAddressWaitMax, ElapsedMicroseconds(start));
+
+				calls++;
+
+				// Let the timer thread run, even on a single core.
+				Thread::yield();
+			}
+
+			CProfiledMutex::Profile send = ctrl->GetLockProfile(CController::LD_Send);
+			CProfiledMutex::Profile registry = ctrl->GetLockProfile(CController::LD_Registry);
+
+			expect(send.acquisitions > 0, "The timer tick did not run");
+			expectEquals(locks, 0);
+			expectEquals(static_cast<int>(registry.contentions), 0);
+			if (!CRealtimeCheck::CanCountLocks())
+				logMessage("Locks are not counted on this platform");
+
+			logMessage(String(calls) + " getter calls: longest " + String(waitMax, 1) + " us, GetIpAddress() longest " + String(ipAddressWaitMax, 1) + " us");
+			logMessage(ToString("Send lock", send));
+			logMessage(ToString("Registry lock", registry));
+		}
+
+		ctrl->SetRate(DCS_Gui, previousRate);
+	}
+
+private:
+	/**
+	 * Time which has passed since the given point in time.
+	 * @param start		Point in time, see Time::getHighResolutionTicks().
+	 * @return	Elapsed time, in microseconds.
+	 */
+	static double ElapsedMicroseconds(int64 start)
+	{
+		return Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start) * 1000000.0;
+	}
+
+	/**
+	 * Format the statistics of one of the CController's locks for the test log.
+	 * @param name		Name of the lock.
+	 * @param profile	Its statistics, see CController::GetLockProfile().
+	 * @return	One line of text.
+	 */
+	static String ToString(const String& name, const CProfiledMutex::Profile& profile)
+	{
+		return name + ": " + String(profile.acquisitions) + " acquisitions, " + String(profile.contentions) + " contended, wait max " + 
+			String(profile.waitMax, 1) + " us, hold max " + String(profile.holdMax, 1) + " us";
+	}
+};
+
+static CLockTest lockTest;
+
+
+} // namespace dbaudio
@@ -0,0 +1,62 @@
+/*
+===============================================================================
+
+Copyright (C) 2019 d&b audiotechnik GmbH & Co. KG. All Rights Reserved.
+
+This file is part of the Soundscape VST, AU, and AAX Plug-in.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY d&b audiotechnik GmbH & Co. KG "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+===============================================================================
+*/
+
+
+#include "../../JuceLibraryCode/JuceHeader.h"
+
+
+/**
+ * Runs all unit tests of the Soundscape Plug-in, see category "Soundscape".
+ * The Plug-in sources include the Plug-in project's JuceLibraryCode, so SoundscapePlugin.jucer must 
+ * have been saved by the Projucer before this project can be built. This includes the header above.
+ * @return	Zero if all tests passed, one otherwise.
+ */
+int main(int argc, char* argv[])
+{
+	ignoreUnused(argc);
+	ignoreUnused(argv);
+
+	// Plug-in instances need a message thread, i.e. to wake their GUIs.
+	ScopedJuceInitialiser_GUI juceInitialiser;
+
+	UnitTestRunner runner;
+	runner.setAssertOnFailure(false);
+	runner.runTestsInCategory("Soundscape");
+
+	int failures = 0;
+	for (int i = 0; i < runner.getNumResults(); ++i)
+		failures += runner.getResult(i)->failures;
+
+	return (failures > 0) ? 1 : 0;
+}
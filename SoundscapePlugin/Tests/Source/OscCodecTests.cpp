@@ -0,0 +1,461 @@
+/*
+===============================================================================
+
+Copyright (C) 2019 d&b audiotechnik GmbH & Co. KG. All Rights Reserved.
+
+This file is part of the Soundscape VST, AU, and AAX Plug-in.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY d&b audiotechnik GmbH & Co. KG "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+===============================================================================
+*/
+
+
+#include "RealtimeCheck.h"
+#include "../../Source/OscCodec.h"
+#include "../../Source/Device.h"
+#include "../../Source/Controller.h"
+#include "../../Source/PluginProcessor.h"
+
+
+namespace dbaudio
+{
+
+
+/**
+ * Number of Plug-in instances used for the per-tick benchmarks, one for each SourceId.
+ */
+static constexpr int BENCHMARK_PLUGIN_COUNT = SOURCE_ID_MAX;
+
+/**
+ * Number of ticks measured by the per-tick benchmarks.
+ */
+static constexpr int BENCHMARK_TICK_COUNT = 200;
+
+/**
+ * Timer interval and packet size assumed by the per-tick benchmarks, as used by default.
+ */
+static constexpr int BENCHMARK_RATE = 50;			//< Milliseconds
+static constexpr int BENCHMARK_MTU = 1472;			//< Ethernet MTU minus IPv4 and UDP headers, in bytes
+
+/**
+ * Number of received addresses identified by the parser benchmark.
+ */
+static constexpr int BENCHMARK_PARSE_COUNT = 1000000;
+
+
+/**
+ * Class COscEncoderTest checks that encoding and sending the OSC messages of a timer tick does not allocate,
+ * and measures how long it takes.
+ */
+class COscEncoderTest : public UnitTest, private COscEncoder::Listener
+{
+public:
+	COscEncoderTest()
+		: UnitTest("COscEncoder", "Soundscape"),
+		m_packetCount(0),
+		m_messageCount(0)
+	{
+	}
+
+	void runTest() override
+	{
+		TestEncoder();
+		TestDeviceTick();
+	}
+
+private:
+	/**
+	 * Encode all SET and GET commands of BENCHMARK_PLUGIN_COUNT sources, as one tick would.
+	 */
+	void TestEncoder()
+	{
+		beginTest("Encoding SET and GET commands for 64 sources does not allocate");
+
+		OwnedArray<COscAddressCache> addresses;
+		for (int i = 0; i < BENCHMARK_PLUGIN_COUNT; ++i)
+		{
+			addresses.add(new COscAddressCache());
+			addresses.getLast()->Update(MAPPING_ID_MIN, SOURCE_ID_MIN + i);
+		}
+
+		COscEncoder encoder(this, BENCHMARK_MTU);
+		m_packetCount = 0;
+		m_messageCount = 0;
+
+		int allocations;
+		double start = Time::getMillisecondCounterHiRes();
+		{
+			CRealtimeCheck check;
+			for (int tick = 0; tick < BENCHMARK_TICK_COUNT; ++tick)
+			{
+				for (const COscAddressCache* cache : addresses)
+				{
+					encoder.AddMessage(cache->GetAddress(OscCmd_SourcePositionXY), cache->GetAddressSize(OscCmd_SourcePositionXY), 0.25f, 0.75f);
+					encoder.AddMessage(cache->GetAddress(OscCmd_ReverbSendGain), cache->GetAddressSize(OscCmd_ReverbSendGain), -6.0f);
+					encoder.AddMessage(cache->GetAddress(OscCmd_SourceSpread), cache->GetAddressSize(OscCmd_SourceSpread), 0.5f);
+					encoder.AddMessage(cache->GetAddress(OscCmd_SourceDelayMode), cache->GetAddressSize(OscCmd_SourceDelayMode), 1);
+					for (int cmd = 0; cmd < OscCmd_MaxIndex; ++cmd)
+						encoder.AddMessage(cache->GetAddress(static_cast<OscCommand>(cmd)), cache->GetAddressSize(static_cast<OscCommand>(cmd)));
+				}
+				encoder.Flush();
+			}
+			allocations = check.GetAllocationCount();
+		}
+		double elapsed = Time::getMillisecondCounterHiRes() - start;
+
+		expectEquals(allocations, 0);
+		expectEquals(m_messageCount, BENCHMARK_TICK_COUNT * BENCHMARK_PLUGIN_COUNT * (4 + OscCmd_MaxIndex));
+		logMessage(String(m_messageCount / BENCHMARK_TICK_COUNT) + " messages in " + String(m_packetCount / BENCHMARK_TICK_COUNT) + 
+			" packets per tick, " + String((elapsed * 1000.0) / BENCHMARK_TICK_COUNT, 1) + " us per tick");
+	}
+
+	/**
+	 * Run a CDevice through complete ticks with SET and GET commands for BENCHMARK_PLUGIN_COUNT Plug-ins.
+	 */
+	void TestDeviceTick()
+	{
+		beginTest("A device tick with 64 Plug-ins does not allocate");
+
+		OwnedArray<CPlugin> plugins;
+		for (int i = 0; i < BENCHMARK_PLUGIN_COUNT; ++i)
+		{
+			plugins.add(new CPlugin());
+			plugins.getLast()->SetComsMode(DCS_Gui, CM_Sync);
+		}
+
+		// Keep the CController's own tick, which visits the same Plug-ins, out of the way.
+		CController* ctrl = CController::GetInstance();
+		int previousRate = ctrl->GetRate();
+		ctrl->SetRate(DCS_Gui, CController::GetSupportedRateRange().second);
+
+		CDevice device;
+		device.SetIpAddress("127.0.0.1", CDevice::ResolveRxAddress("127.0.0.1"));
+
+		// The first tick sizes the device's list of polling Plug-ins, and rebuilds the address caches.
+		RunDeviceTick(device, plugins);
+
+		int allocations = 0;
+		int messages = 0;
+		double start = Time::getMillisecondCounterHiRes();
+		for (int tick = 0; tick < BENCHMARK_TICK_COUNT; ++tick)
+		{
+			for (CPlugin* pro : plugins)
+				pro->SetParameterChanged(DCS_Gui, DCT_AutomationParameters);
+
+			CRealtimeCheck check;
+			RunDeviceTick(device, plugins);
+			allocations += check.GetAllocationCount();
+			messages += device.GetTxMessagesPerTick();
+		}
+		double elapsed = Time::getMillisecondCounterHiRes() - start;
+
+		device.Disconnect();
+		ctrl->SetRate(DCS_Gui, previousRate);
+
+		expectEquals(allocations, 0);
+		expect(messages > 0);
+		logMessage(String(messages / BENCHMARK_TICK_COUNT) + " messages per tick, " + 
+			String((elapsed * 1000.0) / BENCHMARK_TICK_COUNT, 1) + " us per tick");
+	}
+
+	/**
+	 * One tick of the given device, as CController::hiResTimerCallback() does it.
+	 * @param device	The device to send to.
+	 * @param plugins	The Plug-ins bound to the device.
+	 */
+	static void RunDeviceTick(CDevice& device, const OwnedArray<CPlugin>& plugins)
+	{
+		device.BeginTick(static_cast<double>(BENCHMARK_RATE), BENCHMARK_RATE);
+		for (CPlugin* pro : plugins)
+		{
+			pro->SetParamInTransit(device.SendSetCommands(pro));
+			device.AddPollingProcessor(pro);
+		}
+		device.EndTick(BENCHMARK_RATE);
+	}
+
+	/**
+	 * Count the packets and messages produced by the encoder.
+	 * Reimplemented from COscEncoder::Listener.
+	 */
+	void oscPacketEncoded(const char* data, int size, int numMessages) override
+	{
+		ignoreUnused(data);
+		ignoreUnused(size);
+		m_packetCount++;
+		m_messageCount += numMessages;
+	}
+
+	/**
+	 * Number of packets and messages produced by the encoder since the start of the current test.
+	 */
+	int		m_packetCount;
+	int		m_messageCount;
+};
+
+static COscEncoderTest oscEncoderTest;
+
+
+/**
+ * Class COscDecoderTest checks that decoding a received bundle does not allocate, 
+ * and that every message it contains reaches the listener intact.
+ */
+class COscDecoderTest : public UnitTest, private COscEncoder::Listener, private COscDecoder::Listener
+{
+public:
+	COscDecoderTest()
+		: UnitTest("COscDecoder", "Soundscape"),
+		m_messageCount(0),
+		m_valueSum(0.0f)
+	{
+	}
+
+	void runTest() override
+	{
+		beginTest("Decoding a bundle of replies for 64 sources does not allocate");
+
+		// One bundle with a position and a send gain reply for each source, as the DS100 sends them back.
+		COscEncoder encoder(this, COscEncoder::MAX_PACKET_SIZE);
+		COscAddressCache cache;
+		for (SourceId sourceId = SOURCE_ID_MIN; sourceId <= SOURCE_ID_MAX; ++sourceId)
+		{
+			cache.Update(MAPPING_ID_MIN, sourceId);
+			encoder.AddMessage(cache.GetAddress(OscCmd_SourcePositionXY), cache.GetAddressSize(OscCmd_SourcePositionXY), 0.25f, 0.5f);
+			encoder.AddMessage(cache.GetAddress(OscCmd_ReverbSendGain), cache.GetAddressSize(OscCmd_ReverbSendGain), 0.25f);
+		}
+		encoder.Flush();
+
+		const int messagesPerPacket = 2 * (SOURCE_ID_MAX - SOURCE_ID_MIN + 1);
+		m_messageCount = 0;
+		m_valueSum = 0.0f;
+
+		int allocations;
+		bool ok = true;
+		{
+			CRealtimeCheck check;
+			for (int i = 0; i < BENCHMARK_TICK_COUNT; ++i)
+				ok &= COscDecoder::DecodePacket(static_cast<const char*>(m_packet.getData()), static_cast<int>(m_packet.getSize()), this);
+			allocations = check.GetAllocationCount();
+		}
+
+		expect(ok);
+		expectEquals(allocations, 0);
+		expectEquals(m_messageCount, BENCHMARK_TICK_COUNT * messagesPerPacket);
+		expectEquals(m_valueSum, BENCHMARK_TICK_COUNT * messagesPerPacket * 0.25f);
+	}
+
+private:
+	/**
+	 * Keep the encoded bundle, so that it can be decoded.
+	 * Reimplemented from COscEncoder::Listener.
+	 */
+	void oscPacketEncoded(const char* data, int size, int numMessages) override
+	{
+		ignoreUnused(numMessages);
+		m_packet.replaceWith(data, static_cast<size_t>(size));
+	}
+
+	/**
+	 * Count the decoded messages, and add up their first arguments.
+	 * Reimplemented from COscDecoder::Listener.
+	 */
+	void oscMessageDecoded(const COscMessageView& message) override
+	{
+		m_messageCount++;
+		if ((message.GetNumArguments() > 0) && message.IsFloat32(0))
+			m_valueSum += message.GetFloat32(0);
+	}
+
+	/**
+	 * The encoded bundle.
+	 */
+	MemoryBlock	m_packet;
+
+	/**
+	 * Number of messages decoded since the start of the test, and the sum of their first arguments.
+	 */
+	int			m_messageCount;
+	float		m_valueSum;
+};
+
+static COscDecoderTest oscDecoderTest;
+
+
+/**
+ * Class COscAddressParserTest checks that COscAddressParser identifies the replies of a DS100 as the 
+ * String-based parsing in CController::oscMessageDecoded() used to, without allocating, and compares their speed.
+ */
+class COscAddressParserTest : public UnitTest
+{
+public:
+	COscAddressParserTest()
+		: UnitTest("COscAddressParser", "Soundscape")
+	{
+	}
+
+	void runTest() override
+	{
+		TestAddresses();
+		TestBenchmark();
+	}
+
+private:
+	/**
+	 * Parse some well-formed and malformed addresses.
+	 */
+	void TestAddresses()
+	{
+		beginTest("Identifying addresses");
+
+		COscAddressParser::Address address = COscAddressParser::Parse("/dbaudio1/coordinatemapping/source_position_xy/3/17");
+		expectEquals(static_cast<int>(address.response), static_cast<int>(OscRsp_Command));
+		expectEquals(static_cast<int>(address.command), static_cast<int>(OscCmd_SourcePositionXY));
+		expectEquals(address.mappingId, 3);
+		expectEquals(address.sourceId, 17);
+
+		address = COscAddressParser::Parse("/dbaudio1/positioning/source_delaymode/64");
+		expectEquals(static_cast<int>(address.response), static_cast<int>(OscRsp_Command));
+		expectEquals(static_cast<int>(address.command), static_cast<int>(OscCmd_SourceDelayMode));
+		expectEquals(address.sourceId, 64);
+
+		expectEquals(static_cast<int>(COscAddressParser::Parse("/pong").response), static_cast<int>(OscRsp_Pong));
+		expectEquals(static_cast<int>(COscAddressParser::Parse("/dbaudio1/positioning/source_spread/65").response), static_cast<int>(OscRsp_Unknown));
+		expectEquals(static_cast<int>(COscAddressParser::Parse("/dbaudio1/positioning/source_spread/x").response), static_cast<int>(OscRsp_Unknown));
+		expectEquals(static_cast<int>(COscAddressParser::Parse("/dbaudio1/positioning/source_spread/1/2").response), static_cast<int>(OscRsp_Unknown));
+		expectEquals(static_cast<int>(COscAddressParser::Parse("/dbaudio1/coordinatemapping/source_position_xy/5").response), static_cast<int>(OscRsp_Unknown));
+		expectEquals(static_cast<int>(COscAddressParser::Parse("/dbaudio1/matrixinput").response), static_cast<int>(OscRsp_Unknown));
+	}
+
+	/**
+	 * Identify a mix of position, send gain, delay mode and pong replies for all sources with both parsers.
+	 */
+	void TestBenchmark()
+	{
+		beginTest("Parsing received addresses does not allocate, and matches String parsing");
+
+		StringArray addresses;
+		COscAddressCache cache;
+		for (SourceId sourceId = SOURCE_ID_MIN; sourceId <= SOURCE_ID_MAX; ++sourceId)
+		{
+			cache.Update(MAPPING_ID_MIN + (sourceId % MAPPING_ID_MAX), sourceId);
+			addresses.add(cache.GetAddress(OscCmd_SourcePositionXY));
+			addresses.add(cache.GetAddress(OscCmd_ReverbSendGain));
+			addresses.add(cache.GetAddress(OscCmd_SourceDelayMode));
+			addresses.add("/pong");
+		}
+
+		// Both parsers must agree on every address. Their speed is only reported, since timings vary from run to run.
+		for (const String& addressString : addresses)
+		{
+			COscAddressParser::Address address = COscAddressParser::Parse(addressString.toRawUTF8());
+			COscAddressParser::Address legacy = LegacyParse(addressString);
+			expectEquals(static_cast<int>(address.response), static_cast<int>(legacy.response), addressString);
+			if (legacy.response == OscRsp_Command)
+			{
+				expectEquals(static_cast<int>(address.command), static_cast<int>(legacy.command), addressString);
+				expectEquals(address.mappingId, legacy.mappingId, addressString);
+				expectEquals(address.sourceId, legacy.sourceId, addressString);
+			}
+		}
+
+		int checksum = 0;
+		int allocations;
+		double start = Time::getMillisecondCounterHiRes();
+		{
+			CRealtimeCheck check;
+			for (int i = 0; i < BENCHMARK_PARSE_COUNT; ++i)
+				checksum += COscAddressParser::Parse(addresses.getReference(i % addresses.size()).toRawUTF8()).sourceId;
+			allocations = check.GetAllocationCount();
+		}
+		double parserElapsed = Time::getMillisecondCounterHiRes() - start;
+
+		int legacyChecksum = 0;
+		start = Time::getMillisecondCounterHiRes();
+		for (int i = 0; i < BENCHMARK_PARSE_COUNT; ++i)
+			legacyChecksum += LegacyParse(addresses.getReference(i % addresses.size())).sourceId;
+		double legacyElapsed = Time::getMillisecondCounterHiRes() - start;
+
+		expectEquals(allocations, 0);
+		expectEquals(checksum, legacyChecksum);
+		logMessage("COscAddressParser: " + String(BENCHMARK_PARSE_COUNT / (parserElapsed * 1000.0), 1) + " million addresses per second, "
+			"String parsing: " + String(BENCHMARK_PARSE_COUNT / (legacyElapsed * 1000.0), 1) + " million addresses per second");
+	}
+
+	/**
+	 * Identify an address the way CController::oscMessageDecoded() did before COscAddressParser existed,
+	 * limited to the commands which the DS100 is polled for.
+	 * @param addressString	The received address pattern.
+	 * @return	The identified address. sourceId is 0 for pong replies.
+	 */
+	static COscAddressParser::Address LegacyParse(const String& addressString)
+	{
+		static const String delimiterString("/");
+		static const String pongString("/pong");
+		static const String sourcePositionXyString("/dbaudio1/coordinatemapping/source_position_xy");
+		static const String reverbSendGainString("/dbaudio1/matrixinput/reverbsendgain");
+		static const String sourceSpreadString("/dbaudio1/positioning/source_spread");
+		static const String sourceDelayModeString("/dbaudio1/positioning/source_delaymode");
+
+		COscAddressParser::Address address = { OscRsp_Unknown, OscCmd_MaxIndex, 0, 0 };
+		if (addressString.startsWith(pongString))
+		{
+			address.response = OscRsp_Pong;
+			return address;
+		}
+
+		SourceId sourceId = (addressString.fromLastOccurrenceOf(delimiterString, false, true)).getIntValue();
+		if ((sourceId < SOURCE_ID_MIN) || (sourceId > SOURCE_ID_MAX))
+			return address;
+
+		if (addressString.startsWith(sourcePositionXyString))
+		{
+			String mappingString = addressString.upToLastOccurrenceOf(delimiterString, false, true);
+			int mappingId = (mappingString.fromLastOccurrenceOf(delimiterString, false, true)).getIntValue();
+			if ((mappingId < MAPPING_ID_MIN) || (mappingId > MAPPING_ID_MAX))
+				return address;
+
+			address.command = OscCmd_SourcePositionXY;
+			address.mappingId = mappingId;
+		}
+		else if (addressString.startsWith(sourceDelayModeString))
+			address.command = OscCmd_SourceDelayMode;
+		else if (addressString.startsWith(reverbSendGainString))
+			address.command = OscCmd_ReverbSendGain;
+		else if (addressString.startsWith(sourceSpreadString))
+			address.command = OscCmd_SourceSpread;
+		else
+			return address;
+
+		address.response = OscRsp_Command;
+		address.sourceId = sourceId;
+		return address;
+	}
+};
+
+static COscAddressParserTest oscAddressParserTest;
+
+
+} // namespace dbaudio
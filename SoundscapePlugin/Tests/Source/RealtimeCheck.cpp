@@ -0,0 +1,267 @@
+/*
+===============================================================================
+
+Copyright (C) 2019 d&b audiotechnik GmbH & Co. KG. All Rights Reserved.
+
+This file is part of the Soundscape VST, AU, and AAX Plug-in.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY d&b audiotechnik GmbH & Co. KG "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+===============================================================================
+*/
+
+
+#include "RealtimeCheck.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if JUCE_LINUX
+ #include <dlfcn.h>
+ #include <pthread.h>
+#endif
+
+
+/**
+ * Allocation counter of the CRealtimeCheck which is active on the current thread, or nullptr.
+ * A plain pointer, so that reading it from within the allocation functions never allocates itself.
+ */
+static thread_local int* t_allocationCount = nullptr;
+
+/**
+ * Lock counter of the CRealtimeCheck which is active on the current thread, or nullptr.
+ */
+static thread_local int* t_lockCount = nullptr;
+
+/**
+ * Count one heap allocation, if a CRealtimeCheck is active on the current thread.
+ */
+static void CountAllocation()
+{
+	if (t_allocationCount != nullptr)
+		(*t_allocationCount)++;
+}
+
+/**
+ * Count one mutex lock, if a CRealtimeCheck is active on the current thread.
+ */
+static void CountLock()
+{
+	if (t_lockCount != nullptr)
+		(*t_lockCount)++;
+}
+
+
+#if JUCE_LINUX
+
+/**
+ * glibc's own allocation functions, which the replacements below forward to.
+ */
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+
+extern "C" void* malloc(size_t size)
+{
+	CountAllocation();
+	return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size)
+{
+	CountAllocation();
+	return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size)
+{
+	CountAllocation();
+	return __libc_realloc(ptr, size);
+}
+
+/**
+ * The C library's own locking functions, which the replacements below forward to. Looked up on first use,
+ * since dlsym() may lock itself. Atomic, since the first use may happen on several threads at once.
+ */
+using MutexFunction = int (*)(pthread_mutex_t*);
+static std::atomic<MutexFunction> s_mutexLock(nullptr);
+static std::atomic<MutexFunction> s_mutexTryLock(nullptr);
+
+/**
+ * Get one of the C library's locking functions.
+ * @param function	Cached function pointer.
+ * @param name		Name of the function.
+ * @return	The C library's implementation of the function.
+ */
+static MutexFunction GetMutexFunction(std::atomic<MutexFunction>& function, const char* name)
+{
+	MutexFunction result = function.load();
+	if (result == nullptr)
+	{
+		result = reinterpret_cast<MutexFunction>(dlsym(RTLD_NEXT, name));
+		function = result;
+	}
+	return result;
+}
+
+extern "C" int pthread_mutex_lock(pthread_mutex_t* mutex)
+{
+	CountLock();
+	return GetMutexFunction(s_mutexLock, "pthread_mutex_lock")(mutex);
+}
+
+extern "C" int pthread_mutex_trylock(pthread_mutex_t* mutex)
+{
+	CountLock();
+	return GetMutexFunction(s_mutexTryLock, "pthread_mutex_trylock")(mutex);
+}
+
+#endif
+
+
+/**
+ * Allocate memory for operator new. On Linux, std::malloc() is replaced above and counts by itself.
+ * @param size	Number of bytes requested.
+ * @return	The allocated memory, or nullptr.
+ */
+static void* Allocate(size_t size)
+{
+#if !JUCE_LINUX
+	CountAllocation();
+#endif
+	return std::malloc((size > 0) ? size : 1);
+}
+
+void* operator new(size_t size)
+{
+	void* ptr = Allocate(size);
+	if (ptr == nullptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void* operator new[](size_t size)
+{
+	void* ptr = Allocate(size);
+	if (ptr == nullptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	return Allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	return Allocate(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
+
+
+namespace dbaudio
+{
+
+
+/*
+===============================================================================
+ Class CRealtimeCheck
+===============================================================================
+*/
+
+/**
+ * Object constructor. Starts counting on the current thread.
+ */
+CRealtimeCheck::CRealtimeCheck()
+	: m_allocationCount(0),
+	m_lockCount(0)
+{
+	jassert(t_allocationCount == nullptr);
+	t_allocationCount = &m_allocationCount;
+	t_lockCount = &m_lockCount;
+}
+
+/**
+ * Object destructor. Stops counting.
+ */
+CRealtimeCheck::~CRealtimeCheck()
+{
+	t_allocationCount = nullptr;
+	t_lockCount = nullptr;
+}
+
+/**
+ * Get the number of heap allocations which the current thread has made so far.
+ * @return	Number of allocations since construction.
+ */
+int CRealtimeCheck::GetAllocationCount() const
+{
+	return m_allocationCount;
+}
+
+/**
+ * Get the number of mutex locks which the current thread has taken or attempted so far.
+ * @return	Number of locks since construction. Always 0 unless CanCountLocks() returns true.
+ */
+int CRealtimeCheck::GetLockCount() const
+{
+	return m_lockCount;
+}
+
+/**
+ * Check whether mutex locks are counted on this platform.
+ * @return	True on Linux, where pthread_mutex_lock() is replaced.
+ */
+bool CRealtimeCheck::CanCountLocks()
+{
+#if JUCE_LINUX
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+} // namespace dbaudio
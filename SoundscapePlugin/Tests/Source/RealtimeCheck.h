@@ -0,0 +1,77 @@
+/*
+===============================================================================
+
+Copyright (C) 2019 d&b audiotechnik GmbH & Co. KG. All Rights Reserved.
+
+This file is part of the Soundscape VST, AU, and AAX Plug-in.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY d&b audiotechnik GmbH & Co. KG "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+===============================================================================
+*/
+
+
+#pragma once
+
+#include "../../Source/Common.h"
+
+
+namespace dbaudio
+{
+
+
+/**
+ * Class CRealtimeCheck counts the heap allocations and mutex locks made by the current thread while an instance 
+ * of it exists. Allocations through operator new are counted on all platforms. On Linux, malloc(), calloc() and 
+ * realloc() are counted as well, which also covers JUCE's HeapBlock, and so are pthread_mutex_lock() and 
+ * pthread_mutex_trylock(), which covers CriticalSection and std::mutex. Other threads are not affected.
+ * NOTE: Instances must not be nested.
+ */
+class CRealtimeCheck
+{
+public:
+	CRealtimeCheck();
+	~CRealtimeCheck();
+
+	int GetAllocationCount() const;
+	int GetLockCount() const;
+	static bool CanCountLocks();
+
+private:
+	/**
+	 * Number of heap allocations made by the owning thread since construction.
+	 */
+	int		m_allocationCount;
+
+	/**
+	 * Number of mutex locks taken or attempted by the owning thread since construction.
+	 */
+	int		m_lockCount;
+
+	JUCE_DECLARE_NON_COPYABLE(CRealtimeCheck)
+};
+
+
+} // namespace dbaudio
@@ -0,0 +1,180 @@
+/*
+===============================================================================
+
+Copyright (C) 2019 d&b audiotechnik GmbH & Co. KG. All Rights Reserved.
+
+This file is part of the Soundscape VST, AU, and AAX Plug-in.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY d&b audiotechnik GmbH & Co. KG "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+===============================================================================
+*/
+
+
+
+#include "RealtimeCheck.h"
+#include "../../Source/Controller.h"
+#include "../../Source/PluginProcessor.h"
+
+
+namespace dbaudio
+{
+
+
+/**
+ * Number of host automation changes measured per parameter.
+ */
+static constexpr int AUTOMATION_CHANGE_COUNT = 1000;
+
+
+/**
+ * Change a parameter the way a host wrapper does: set its value, then notify its listeners,
+ * which calls CPlugin::parameterValueChanged().
+ * @param parameter		The parameter to change.
+ * @param newValue		New normalized value.
+ */
+static void ChangeFromHost(AudioProcessorParameter& parameter, float newValue)
+{
+	parameter.setValue(newValue);
+	parameter.sendValueChangedMessageToListeners(newValue);
+}
+
+
+/**
+ * Class CRealtimeTest checks that the Plug-in's part of the host automation path, which may run on the host's 
+ * audio thread, neither allocates nor locks. The locks which JUCE's own parameter plumbing takes around it are 
+ * reported separately by CHostChangeBenchmark, since they are outside the Plug-in's control.
+ */
+class CRealtimeTest : public UnitTest
+{
+public:
+	CRealtimeTest()
+		: UnitTest("Realtime", "Soundscape")
+	{
+	}
+
+	void runTest() override
+	{
+		CPlugin plugin;
+		CController* ctrl = CController::GetInstance();
+
+		// Cover the low-latency path as well, which arms the SET deadline.
+		bool previousLowLatencyMode = ctrl->GetLowLatencyMode();
+		ctrl->SetLowLatencyMode(true);
+
+		// Once through all parameters, so that anything created on first use exists.
+		auto& parameters = plugin.getParameters();
+		for (int paramIdx = 0; paramIdx < ParamIdx_MaxIndex; ++paramIdx)
+			ChangeFromHost(*parameters[paramIdx], 0.25f);
+
+		beginTest("CPlugin::parameterValueChanged() does not allocate or lock");
+		{
+			int allocations = 0;
+			int locks = 0;
+			for (int paramIdx = 0; paramIdx < ParamIdx_MaxIndex; ++paramIdx)
+			{
+				AudioProcessorParameter& parameter = *parameters[paramIdx];
+				for (int i = 0; i < AUTOMATION_CHANGE_COUNT; ++i)
+				{
+					float newValue = ((i % 2) == 0) ? 0.75f : 0.25f;
+
+					// Only the value is set beforehand, without notifying anyone, as the host wrapper does.
+					parameter.setValue(newValue);
+
+					CRealtimeCheck check;
+					plugin.parameterValueChanged(paramIdx, newValue);
+					allocations += check.GetAllocationCount();
+					locks += check.GetLockCount();
+				}
+			}
+
+			expectEquals(allocations, 0);
+			expectEquals(locks, 0);
+			if (!CRealtimeCheck::CanCountLocks())
+				logMessage("Locks are not counted on this platform");
+		}
+
+		ctrl->SetLowLatencyMode(previousLowLatencyMode);
+	}
+};
+
+static CRealtimeTest realtimeTest;
+
+
+/**
+ * Class CHostChangeBenchmark reports the allocations and locks of a complete host parameter change, 
+ * including JUCE's own setValue() and listener notification, which are outside the Plug-in's control.
+ * Only informative, nothing is asserted.
+ */
+class CHostChangeBenchmark : public UnitTest
+{
+public:
+	CHostChangeBenchmark()
+		: UnitTest("Host parameter change benchmark", "Soundscape")
+	{
+	}
+
+	void runTest() override
+	{
+		CPlugin plugin;
+		CController* ctrl = CController::GetInstance();
+
+		bool previousLowLatencyMode = ctrl->GetLowLatencyMode();
+		ctrl->SetLowLatencyMode(true);
+
+		auto& parameters = plugin.getParameters();
+		for (int paramIdx = 0; paramIdx < ParamIdx_MaxIndex; ++paramIdx)
+			ChangeFromHost(*parameters[paramIdx], 0.25f);
+
+		beginTest("Measuring the allocations and locks of a complete host parameter change");
+		{
+			for (int paramIdx = 0; paramIdx < ParamIdx_MaxIndex; ++paramIdx)
+			{
+				AudioProcessorParameter& parameter = *parameters[paramIdx];
+				int allocations = 0;
+				int locks = 0;
+				for (int i = 0; i < AUTOMATION_CHANGE_COUNT; ++i)
+				{
+					float newValue = ((i % 2) == 0) ? 0.75f : 0.25f;
+
+					CRealtimeCheck check;
+					ChangeFromHost(parameter, newValue);
+					allocations += check.GetAllocationCount();
+					locks += check.GetLockCount();
+				}
+
+				logMessage(parameter.getName(32) + ": " + String(static_cast<double>(allocations) / AUTOMATION_CHANGE_COUNT, 1) + " allocations and " + 
+					String(static_cast<double>(locks) / AUTOMATION_CHANGE_COUNT, 1) + " locks per change, including setValue() and JUCE's listener notification");
+			}
+		}
+
+		ctrl->SetLowLatencyMode(previousLowLatencyMode);
+	}
+};
+
+static CHostChangeBenchmark hostChangeBenchmark;
+
+
+} // namespace dbaudio